@@ -0,0 +1,317 @@
+#include "AlphaBetaSearch.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+
+#include "../BoardEvaluator.h"
+
+namespace
+{
+    // Search never gets this deep, the depth is limited long before.
+    constexpr int MAX_PLY = MoveOrdering::MAX_PLY;
+
+    // Null move: the reduction grows with the depth, and the cutoffs this deep are verified.
+    constexpr int NULL_MOVE_MIN_DEPTH = 3;
+    constexpr int NULL_MOVE_VERIFICATION_DEPTH = 8;
+    // Futility margins per ply of depth left, in centipawns.
+    constexpr int REVERSE_FUTILITY_MAX_DEPTH = 6;
+    constexpr int REVERSE_FUTILITY_MARGIN = 120;
+    constexpr int FUTILITY_MAX_DEPTH = 3;
+    constexpr int FUTILITY_MARGIN = 150;
+    // Late-move reductions start from this depth and move number.
+    constexpr int LMR_MIN_DEPTH = 3;
+    constexpr int LMR_MIN_MOVES = 3;
+
+    // Reductions of the late moves by depth and move number: 0.75 + ln(depth) * ln(move number) / 2.25 plies.
+    const std::array<std::array<uint8_t, 64>, 64> LMR_REDUCTIONS = []() {
+        std::array<std::array<uint8_t, 64>, 64> reductions{};
+        for (int depth = 1; depth < 64; depth++)
+        {
+            for (int moveNumber = 1; moveNumber < 64; moveNumber++)
+            {
+                reductions[depth][moveNumber] = uint8_t(0.75 + std::log(depth) * std::log(moveNumber) / 2.25);
+            }
+        }
+        return reductions;
+    }();
+
+    // Only pawns left means zugzwang is likely, passing the turn might then be better than any real move.
+    bool hasPiecesBesidesPawns(const Board& board)
+    {
+        const Piece color = board.getCurrentPlayer() == Color::WHITE ? Piece::WHITE : Piece::BLACK;
+        for (char square = 0; square < 64; square++)
+        {
+            const Piece piece = board.getSquare(square);
+            if (!!(piece & color) && !(piece & (Piece::PAWN | Piece::KING)))
+                return true;
+        }
+        return false;
+    }
+
+    // Depths skipped by the helper threads: a helper skips the depths for which (depth + phase) / size is odd.
+    // The helpers with larger skip sizes are mostly ahead of the main search.
+    constexpr unsigned int HELPER_SKIP_SIZE[] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+    constexpr unsigned int HELPER_SKIP_PHASE[] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+    constexpr unsigned int HELPER_SKIP_PATTERNS = sizeof(HELPER_SKIP_SIZE) / sizeof(HELPER_SKIP_SIZE[0]);
+}
+
+AlphaBetaSearch::AlphaBetaSearch(TranspositionTable* table, unsigned int threadIndex, const AlphaBetaSettings& settings)
+    : table(table)
+    , threadIndex(threadIndex)
+    , settings(settings)
+{
+}
+
+void AlphaBetaSearch::run(const Board& board, const std::atomic<bool>& stop, unsigned int maxDepth,
+    const std::function<void(const SearchResult&)>& onDepthCompleted)
+{
+    this->stop = &stop;
+    aborted = false;
+    nodes = 0u;
+    cutoffs = 0u;
+    firstMoveCutoffs = 0u;
+    rootBestMove = Move();
+    ordering.newSearch();
+    // Sized once, growing the list during the search would move the lists of the plies being searched.
+    moveBuffers.resize(MAX_PLY);
+    for (unsigned int depth = 1u; depth <= maxDepth && depth < MAX_PLY; depth++)
+    {
+        if (skipsDepth(depth))
+            continue;
+        const int score = search(board, -INFINITE_SCORE, INFINITE_SCORE, (int)depth, 0);
+        if (aborted)
+            break;
+        onDepthCompleted(SearchResult{ rootBestMove, score, depth, searchedNodes() });
+        // Nothing deeper can change a forced mate the search already sees.
+        if (isMateScore(score) || !rootBestMove.isValid())
+            break;
+    }
+    this->stop = nullptr;
+}
+
+SearchResult AlphaBetaSearch::searchDepth(const Board& board, unsigned int depth)
+{
+    SearchResult result;
+    const std::atomic<bool> neverStop = false;
+    run(board, neverStop, depth, [&result](const SearchResult& completed) {
+        result = completed;
+    });
+    return result;
+}
+
+uint64_t AlphaBetaSearch::searchedNodes() const
+{
+    return nodes.load(std::memory_order_relaxed);
+}
+
+float AlphaBetaSearch::firstMoveCutoffRate() const
+{
+    return cutoffs > 0u ? float(firstMoveCutoffs) / cutoffs : 0.0f;
+}
+
+bool AlphaBetaSearch::isMateScore(int score)
+{
+    return std::abs(score) >= MATE_SCORE - MAX_PLY;
+}
+
+int AlphaBetaSearch::scoreToTable(int score, int ply)
+{
+    if (!isMateScore(score))
+        return score;
+    return score > 0 ? score + ply : score - ply;
+}
+
+int AlphaBetaSearch::scoreFromTable(int score, int ply)
+{
+    if (!isMateScore(score))
+        return score;
+    return score > 0 ? score - ply : score + ply;
+}
+
+bool AlphaBetaSearch::skipsDepth(unsigned int depth) const
+{
+    // The main search and the first depth of every helper are never skipped, a helper always has a move.
+    if (threadIndex == 0u || depth == 1u)
+        return false;
+    const unsigned int pattern = (threadIndex - 1u) % HELPER_SKIP_PATTERNS;
+    return ((depth + HELPER_SKIP_PHASE[pattern]) / HELPER_SKIP_SIZE[pattern]) % 2u != 0u;
+}
+
+int AlphaBetaSearch::search(const Board& board, int alpha, int beta, int depth, int ply)
+{
+    if (stop->load(std::memory_order_relaxed))
+    {
+        aborted = true;
+        return 0;
+    }
+    nodes.store(nodes.load(std::memory_order_relaxed) + 1u, std::memory_order_relaxed);
+    if (ply > 0 && (board.isRepetition() || board.noProgress() || board.insufficientMaterial()))
+        return 0;
+    if (ply >= MAX_PLY)
+        return evaluate(board);
+    const bool inCheck = board.isCheck();
+    if (inCheck && settings.checkExtensions)
+        depth++;
+    if (depth <= 0)
+        return quiescence(board, alpha, beta, ply);
+
+    TranspositionEntry entry;
+    uint16_t hashMove = 0u;
+    if (table && table->probe(board.getHash(), entry))
+    {
+        hashMove = entry.move;
+        if (ply > 0 && entry.depth >= unsigned(depth))
+        {
+            const int score = scoreFromTable(entry.score, ply);
+            if (entry.bound == ScoreBound::EXACT
+                || (entry.bound == ScoreBound::LOWER && score >= beta)
+                || (entry.bound == ScoreBound::UPPER && score <= alpha))
+                return score;
+        }
+    }
+
+    // Only the null window searches are pruned, the principal variation is searched in full.
+    const bool pvNode = beta - alpha > 1;
+    const bool prunable = !pvNode && !inCheck;
+    const int staticEval = prunable ? evaluate(board) : 0;
+    if (prunable && settings.reverseFutilityPruning && depth <= REVERSE_FUTILITY_MAX_DEPTH && !isMateScore(beta)
+        && staticEval - REVERSE_FUTILITY_MARGIN * depth >= beta)
+        return staticEval - REVERSE_FUTILITY_MARGIN * depth;
+
+    // Two passes in a row would only search the same position shallower.
+    const bool afterNullMove = ply > 0 && !playedMoves[ply - 1].isValid();
+    if (prunable && settings.nullMovePruning && !verifyingNullMove && !afterNullMove && ply > 0
+        && depth >= NULL_MOVE_MIN_DEPTH && staticEval >= beta && !isMateScore(beta) && hasPiecesBesidesPawns(board))
+    {
+        const int reduction = 3 + depth / 6;
+        playedMoves[ply] = Move();
+        Board child = board;
+        child.applyNullMove();
+        int score = -search(child, -beta, -beta + 1, depth - 1 - reduction, ply + 1);
+        if (aborted)
+            return 0;
+        if (score >= beta)
+        {
+            // A pass can't prove a mate.
+            if (isMateScore(score))
+                score = beta;
+            if (depth < NULL_MOVE_VERIFICATION_DEPTH)
+                return score;
+            verifyingNullMove = true;
+            const int verified = search(board, beta - 1, beta, depth - reduction, ply);
+            verifyingNullMove = false;
+            if (aborted)
+                return 0;
+            if (verified >= beta)
+                return score;
+        }
+    }
+    const bool futile = prunable && settings.futilityPruning && depth <= FUTILITY_MAX_DEPTH && !isMateScore(alpha)
+        && staticEval + FUTILITY_MARGIN * depth <= alpha;
+
+    std::vector<Move>& moves = moveBuffers[ply];
+    board.findPossibleMoves(moves);
+    if (moves.size() == 0u)
+        return inCheck ? -MATE_SCORE + ply : 0;
+    // The best move of the previous iteration goes first at the root.
+    if (ply == 0 && rootBestMove.isValid())
+        hashMove = TranspositionTable::packMove(rootBestMove);
+    const Move previous = ply > 0 ? playedMoves[ply - 1] : Move();
+    MovePicker picker(board, moves, hashMove, ordering, ply, previous);
+
+    const int originalAlpha = alpha;
+    int bestScore = -INFINITE_SCORE;
+    Move bestMove;
+    // Quiet moves that didn't cause a cutoff, their history suffers if a later one does.
+    Move failedQuiets[64];
+    int failedQuietCount = 0;
+    int moveCount = 0;
+    Move move;
+    while (picker.next(move))
+    {
+        const bool quiet = board.capturedPiece(move) == Piece::NONE && !move.isPromotion();
+        // Discovered checks aren't seen here, a few of them may get pruned.
+        if (futile && moveCount > 0 && quiet && !board.givesDirectCheck(move))
+            continue;
+
+        playedMoves[ply] = move;
+        Board child = board;
+        child.applyMove(move);
+        int score;
+        if (moveCount == 0)
+        {
+            score = -search(child, -beta, -alpha, depth - 1, ply + 1);
+        }
+        else
+        {
+            int reduction = 0;
+            if (settings.lateMoveReductions && depth >= LMR_MIN_DEPTH && moveCount >= LMR_MIN_MOVES && quiet && !inCheck && !child.isCheck())
+            {
+                reduction = LMR_REDUCTIONS[std::min(depth, 63)][std::min(moveCount, 63)] - (pvNode ? 1 : 0);
+                reduction = std::clamp(reduction, 0, depth - 2);
+            }
+            // The first move is expected to be the best, the others only have to be proven worse with a null window.
+            score = -search(child, -alpha - 1, -alpha, depth - 1 - reduction, ply + 1);
+            if (score > alpha && reduction > 0)
+                score = -search(child, -alpha - 1, -alpha, depth - 1, ply + 1);
+            if (score > alpha && score < beta)
+                score = -search(child, -beta, -alpha, depth - 1, ply + 1);
+        }
+        if (aborted)
+            return 0;
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestMove = move;
+            if (ply == 0)
+                rootBestMove = move;
+        }
+        alpha = std::max(alpha, score);
+        if (alpha >= beta)
+        {
+            cutoffs++;
+            if (moveCount == 0)
+                firstMoveCutoffs++;
+            if (quiet)
+                ordering.updateQuietCutoff(board.getCurrentPlayer(), ply, depth, move, previous, failedQuiets, failedQuietCount);
+            break;
+        }
+        if (quiet && failedQuietCount < 64)
+            failedQuiets[failedQuietCount++] = move;
+        moveCount++;
+    }
+
+    if (table)
+    {
+        const ScoreBound bound = bestScore >= beta ? ScoreBound::LOWER
+            : bestScore > originalAlpha ? ScoreBound::EXACT : ScoreBound::UPPER;
+        // A move that failed low isn't known to be any better than the others.
+        const uint16_t storedMove = bound == ScoreBound::UPPER ? 0u : TranspositionTable::packMove(bestMove);
+        table->store(board.getHash(), scoreToTable(bestScore, ply), unsigned(depth), bound, storedMove);
+    }
+    return bestScore;
+}
+
+int AlphaBetaSearch::evaluate(const Board& board) const
+{
+    const int whiteScore = int(BoardEvaluator::evaluateBoard(board) * 100.0f);
+    return board.getCurrentPlayer() == Color::WHITE ? whiteScore : -whiteScore;
+}
+
+int AlphaBetaSearch::quiescence(const Board& board, int alpha, int beta, int ply)
+{
+    // The leaf itself was counted already.
+    uint64_t quiescenceNodes = 0u;
+    const float score = BoardEvaluator::searchQuiescent(board, alpha / 100.0f, beta / 100.0f, settings.quiescenceDepth, &quiescenceNodes);
+    nodes.store(nodes.load(std::memory_order_relaxed) + quiescenceNodes - 1u, std::memory_order_relaxed);
+    // The capture search only follows forced lines when it finds a mate, its plies to the mate add to this ply.
+    const float maxMateDistance = float(settings.quiescenceDepth);
+    if (score <= BoardEvaluator::MATED + maxMateDistance)
+        return -MATE_SCORE + ply + int(std::lround(score - BoardEvaluator::MATED));
+    if (score >= -BoardEvaluator::MATED - maxMateDistance)
+        return MATE_SCORE - ply - int(std::lround(-BoardEvaluator::MATED - score));
+    return int(score * 100.0f);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "../Board.h"
+#include "../Move.h"
+#include "AlphaBetaSettings.h"
+#include "MovePicker.h"
+#include "TranspositionTable.h"
+
+// Best move and score of a completed iteration of the iterative deepening.
+struct SearchResult
+{
+    Move bestMove;
+    // Centipawns from the point of view of the player in turn, mates are near AlphaBetaSearch::MATE_SCORE.
+    int score = 0;
+    unsigned int depth = 0u;
+    uint64_t nodes = 0u;
+};
+
+// Iterative deepening principal variation search. The positions are made by copying the board and applying
+// the move, so the parent is left as it was and nothing has to be unmade. An instance is used by one thread,
+// the transposition table may be shared with other searches. Searches of the same position sharing a table make
+// a Lazy SMP search: the helpers skip some of the depths, so that the threads mostly search at different depths,
+// and the results they store in the table speed up the others.
+class AlphaBetaSearch
+{
+public:
+    static constexpr int MATE_SCORE = 1000000;
+    static constexpr int INFINITE_SCORE = MATE_SCORE + 1;
+
+    // Without a table nothing is remembered between the searched positions. Thread index zero is the main search,
+    // the others are helpers.
+    explicit AlphaBetaSearch(TranspositionTable* table = nullptr, unsigned int threadIndex = 0u,
+        const AlphaBetaSettings& settings = AlphaBetaSettings());
+
+    // Searches the position one depth deeper at a time until stop is set or maxDepth has been searched.
+    // Every completed depth is reported, an interrupted one is thrown away.
+    void run(const Board& board, const std::atomic<bool>& stop, unsigned int maxDepth,
+        const std::function<void(const SearchResult&)>& onDepthCompleted);
+    // Searches the position to the given depth without interruptions.
+    SearchResult searchDepth(const Board& board, unsigned int depth);
+
+    // Nodes searched by the last run, also while it's running.
+    uint64_t searchedNodes() const;
+    // Share of the beta cutoffs of the last run caused by the first move searched, a measure of the move ordering.
+    float firstMoveCutoffRate() const;
+
+    static bool isMateScore(int score);
+    // Mate scores are stored in the table as distances from the stored position, not from the root.
+    static int scoreToTable(int score, int ply);
+    static int scoreFromTable(int score, int ply);
+
+private:
+    bool skipsDepth(unsigned int depth) const;
+    int search(const Board& board, int alpha, int beta, int depth, int ply);
+    int evaluate(const Board& board) const;
+    // Resolves the captures at the leaves, shared with the Monte Carlo leaf evaluation.
+    // Mates found by the capture search are scored as mates at this ply, so the table can adjust them.
+    int quiescence(const Board& board, int alpha, int beta, int ply);
+
+    // Moves of each ply, kept between the searches so they don't need to be allocated again.
+    std::vector<std::vector<Move>> moveBuffers;
+    // The moves leading from the root to the position being searched, by ply.
+    Move playedMoves[MoveOrdering::MAX_PLY];
+    MoveOrdering ordering;
+    TranspositionTable* table;
+    unsigned int threadIndex;
+    AlphaBetaSettings settings;
+    // Set while a null move cutoff is verified, no null moves are tried then.
+    bool verifyingNullMove = false;
+    const std::atomic<bool>* stop = nullptr;
+    bool aborted = false;
+    // Only written by the searching thread, others may read it for statistics.
+    std::atomic<uint64_t> nodes = 0u;
+    uint64_t cutoffs = 0u;
+    uint64_t firstMoveCutoffs = 0u;
+    Move rootBestMove;
+};
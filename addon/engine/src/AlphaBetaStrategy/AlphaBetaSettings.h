@@ -0,0 +1,24 @@
+#pragma once
+
+// Tunable parameters of the alpha-beta search. The defaults match the plain principal variation search,
+// each selective technique can be switched on separately to measure what it brings.
+struct AlphaBetaSettings
+{
+    // Captures searched at most at the leaves.
+    unsigned int quiescenceDepth = 8u;
+    // Null-move pruning: when passing the turn still fails high with a reduced search, the position is cut off.
+    // Not tried in check, after a pass, or when the player has only pawns left, where passing may be the best move
+    // (zugzwang). Deep cutoffs are verified with a reduced search of the real moves.
+    bool nullMovePruning = false;
+    // Late-move reductions: quiet moves late in the order are searched shallower, by an amount growing with
+    // the logarithms of the depth and the move number, and again at full depth if they beat alpha.
+    bool lateMoveReductions = false;
+    // Reverse futility pruning: near the leaves a position whose static evaluation beats beta by a margin
+    // growing with the depth is cut off without searching it.
+    bool reverseFutilityPruning = false;
+    // Futility pruning: near the leaves the quiet moves are skipped when the static evaluation is so far below
+    // alpha that a quiet move can't make up for it.
+    bool futilityPruning = false;
+    // Check extensions: a position in check is searched one ply deeper, so the escapes are never cut short.
+    bool checkExtensions = false;
+};
@@ -0,0 +1,177 @@
+#include "AlphaBetaStrategy.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+    // The speedup is measured on a depth the threads completed within this time, one thread may take many times longer.
+    constexpr float SPEEDUP_MAX_SECONDS = 0.25f;
+}
+
+AlphaBetaStrategy::AlphaBetaStrategy(const AlphaBetaSettings& settings, unsigned int maxDepth, size_t hashMegabytes,
+    unsigned int threadCount)
+    : settings(settings)
+    , maxDepth(maxDepth)
+    , table(hashMegabytes)
+{
+    if (threadCount == 0u)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int i = 0u; i < threadCount; i++)
+    {
+        searches.push_back(std::make_unique<AlphaBetaSearch>(&table, i, settings));
+    }
+}
+
+AlphaBetaStrategy::~AlphaBetaStrategy()
+{
+    stopSearch();
+}
+
+std::vector<float> AlphaBetaStrategy::measureTimeToDepth(const Board& position, unsigned int depth, unsigned int threadCount,
+    const AlphaBetaSettings& settings)
+{
+    AlphaBetaStrategy strategy(settings, depth, 64u, threadCount);
+    strategy.board = position;
+    strategy.startSearch();
+    // The main search ends at the depth and then stops the helpers.
+    while (!strategy.searchFinished)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    strategy.stopSearch();
+    std::lock_guard<std::mutex> lock(strategy.resultMutex);
+    return strategy.depthSeconds;
+}
+
+void AlphaBetaStrategy::tickComputation()
+{
+    if (searchThreads.empty())
+        startSearch();
+
+    // The search threads do the work, the tick only waits for its time slice to pass.
+    std::this_thread::sleep_until(TimeManagement::tickDeadline());
+
+    // This must be set in this method if it's our turn. A search that has ended can't get any better.
+    confidence = searchFinished ? 1.0f : 0.5f;
+}
+
+void AlphaBetaStrategy::applyMoveToStrategy(const Move&)
+{
+    const bool searched = !searchThreads.empty();
+    stopSearch();
+    if (searched)
+    {
+        printSearchStatistics();
+        // Only the first search starts with an empty table, as the one thread does.
+        if (searches.size() > 1u && !speedupMeasured)
+            measureSpeedup();
+    }
+    std::lock_guard<std::mutex> lock(resultMutex);
+    completedResult = SearchResult();
+    depthSeconds.clear();
+}
+
+Move AlphaBetaStrategy::getBestMove()
+{
+    {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        if (completedResult.depth > 0u)
+            return completedResult.bestMove;
+    }
+    // Asked to move before the first iteration completed, a shallow search on this thread is quick.
+    return AlphaBetaSearch().searchDepth(board, 1u).bestMove;
+}
+
+void AlphaBetaStrategy::startSearch()
+{
+    stopRequested = false;
+    searchFinished = false;
+    table.newSearch();
+    searchStartTime = std::chrono::system_clock::now();
+    searchedPosition = board;
+    // The searches work on their own copies of the board, the game keeps changing the original.
+    searchThreads.emplace_back([this, searchBoard = board]() {
+        searches[0]->run(searchBoard, stopRequested, maxDepth, [this](const SearchResult& result) {
+            const float seconds = Duration(std::chrono::system_clock::now() - searchStartTime).count();
+            std::lock_guard<std::mutex> lock(resultMutex);
+            completedResult = result;
+            depthSeconds.resize(std::max<size_t>(depthSeconds.size(), result.depth), 0.0f);
+            depthSeconds[result.depth - 1u] = seconds;
+        });
+        // The helpers only work for the main search.
+        stopRequested = true;
+        searchFinished = true;
+    });
+    for (size_t i = 1u; i < searches.size(); i++)
+    {
+        searchThreads.emplace_back([this, i, searchBoard = board]() {
+            searches[i]->run(searchBoard, stopRequested, maxDepth, [](const SearchResult&) {});
+        });
+    }
+}
+
+void AlphaBetaStrategy::stopSearch()
+{
+    stopRequested = true;
+    for (std::thread& thread : searchThreads)
+    {
+        thread.join();
+    }
+    searchThreads.clear();
+}
+
+void AlphaBetaStrategy::printSearchStatistics()
+{
+    const float seconds = std::max(Duration(std::chrono::system_clock::now() - searchStartTime).count(), 0.001f);
+    {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        std::cout << "Alpha-beta depth: " << completedResult.depth << ", table usage: " << table.usagePermille() / 10u << "%"
+            << ", first move cutoffs: " << unsigned(searches[0]->firstMoveCutoffRate() * 100.0f) << "%" << std::endl;
+        // The time to depth is what the helper threads should bring down.
+        std::cout << "Time to depth:";
+        for (size_t i = 0u; i < depthSeconds.size(); i++)
+        {
+            if (depthSeconds[i] > 0.0f)
+                std::cout << " " << i + 1u << ": " << depthSeconds[i] * 1000.0f << " ms";
+        }
+        std::cout << std::endl;
+    }
+    uint64_t totalNodes = 0u;
+    for (size_t i = 0u; i < searches.size(); i++)
+    {
+        const uint64_t nodes = searches[i]->searchedNodes();
+        totalNodes += nodes;
+        std::cout << "Thread " << i << ": " << nodes << " nodes, " << uint64_t(nodes / seconds) << " nodes/s" << std::endl;
+    }
+    if (searches.size() > 1u)
+    {
+        std::cout << "Total: " << uint64_t(totalNodes / seconds) << " nodes/s";
+        if (speedupDepth > 0u)
+            std::cout << ", speedup over one thread: " << speedup << "x (time to depth " << speedupDepth << ", first move)";
+        std::cout << std::endl;
+    }
+}
+
+void AlphaBetaStrategy::measureSpeedup()
+{
+    speedupMeasured = true;
+    unsigned int depth = 0u;
+    float threadSeconds = 0.0f;
+    {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        for (size_t i = 0u; i < depthSeconds.size() && depthSeconds[i] <= SPEEDUP_MAX_SECONDS; i++)
+        {
+            depth = unsigned(i + 1u);
+            threadSeconds = depthSeconds[i];
+        }
+    }
+    if (depth == 0u || threadSeconds <= 0.0f)
+        return;
+    const std::vector<float> singleThread = measureTimeToDepth(searchedPosition, depth, 1u, settings);
+    if (singleThread.size() < depth)
+        return;
+    speedup = singleThread[depth - 1u] / threadSeconds;
+    speedupDepth = depth;
+    std::cout << "Speedup over one thread: " << speedup << "x (time to depth " << depth << ")" << std::endl;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../GreyPawnChess.h"
+#include "AlphaBetaSearch.h"
+
+// Classic depth-first searcher. The iterative deepening runs on a search thread of its own, started by the first
+// tick after a move, so a deep iteration may span many ticks. The best move of the deepest completed iteration
+// is available at every tick. The transposition table is kept from move to move.
+// With more than one thread the helper threads search the same position and share the table with the main search,
+// only the main search reports moves.
+class AlphaBetaStrategy : public GreyPawnChess
+{
+public:
+    // Zero threads means one per hardware thread.
+    explicit AlphaBetaStrategy(const AlphaBetaSettings& settings = AlphaBetaSettings(), unsigned int maxDepth = 64u,
+        size_t hashMegabytes = 64u, unsigned int threadCount = 0u);
+    ~AlphaBetaStrategy();
+
+    // Searches the position to the given depth and returns the seconds the main search took to complete each depth.
+    // Comparing the times of a run with more threads to a run with one thread gives the speedup of the helpers.
+    static std::vector<float> measureTimeToDepth(const Board& position, unsigned int depth, unsigned int threadCount,
+        const AlphaBetaSettings& settings = AlphaBetaSettings());
+
+protected:
+    void tickComputation() override;
+    void applyMoveToStrategy(const Move& move) override;
+    Move getBestMove() override;
+
+private:
+    void startSearch();
+    void stopSearch();
+    void printSearchStatistics();
+    // Repeats the search just finished with one thread, to the deepest depth the threads completed quickly.
+    void measureSpeedup();
+
+    AlphaBetaSettings settings;
+    unsigned int maxDepth;
+    TranspositionTable table;
+    // The first search is the main one.
+    std::vector<std::unique_ptr<AlphaBetaSearch>> searches;
+    std::vector<std::thread> searchThreads;
+    TimePoint searchStartTime;
+    Board searchedPosition;
+    std::atomic<bool> stopRequested = false;
+    std::atomic<bool> searchFinished = false;
+    // Written by the search thread after every completed depth.
+    std::mutex resultMutex;
+    SearchResult completedResult;
+    // Seconds from the start of the search to the completion of each depth by the main search, zero for none.
+    std::vector<float> depthSeconds;
+    // Time to depth of one thread divided by that of all the threads, measured once on the first search.
+    bool speedupMeasured = false;
+    float speedup = 0.0f;
+    unsigned int speedupDepth = 0u;
+};
@@ -0,0 +1,251 @@
+#include "MovePicker.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include "../BoardEvaluator.h"
+#include "TranspositionTable.h"
+
+namespace
+{
+    // Captures not losing material score above this, the losing ones below.
+    constexpr int GOOD_CAPTURE_SCORE = 1000000;
+
+    // Most valuable victims first, the cheapest attackers first among them.
+    int mvvLvaScore(const Board& board, const Move& move)
+    {
+        int score = int(BoardEvaluator::pieceValue(board.capturedPiece(move))) * 10
+            - int(BoardEvaluator::pieceValue(board.getSquare(move.from[0])));
+        if (move.isPromotion())
+            score += int(BoardEvaluator::pieceValue(move.promotion)) * 10;
+        return score;
+    }
+
+    bool isQuiet(const Board& board, const Move& move)
+    {
+        return board.capturedPiece(move) == Piece::NONE && !move.isPromotion();
+    }
+}
+
+MoveOrdering::MoveOrdering()
+{
+    clear();
+}
+
+void MoveOrdering::clear()
+{
+    std::memset(killers, 0, sizeof(killers));
+    std::memset(counterMoves, 0, sizeof(counterMoves));
+    std::memset(historyTable, 0, sizeof(historyTable));
+}
+
+void MoveOrdering::newSearch()
+{
+    std::memset(killers, 0, sizeof(killers));
+    for (auto& playerHistory : historyTable)
+    {
+        for (auto& fromHistory : playerHistory)
+        {
+            for (int& value : fromHistory)
+            {
+                value /= 2;
+            }
+        }
+    }
+}
+
+uint16_t MoveOrdering::killer(int ply, int slot) const
+{
+    return ply < MAX_PLY ? killers[ply][slot] : 0u;
+}
+
+uint16_t MoveOrdering::counterMove(const Move& previous) const
+{
+    return previous.isValid() ? counterMoves[int(previous.from[0])][int(previous.to[0])] : 0u;
+}
+
+int MoveOrdering::history(Color player, const Move& move) const
+{
+    return historyTable[int(player)][int(move.from[0])][int(move.to[0])];
+}
+
+void MoveOrdering::updateQuietCutoff(Color player, int ply, int depth, const Move& move, const Move& previous,
+    const Move* failedQuiets, int failedCount)
+{
+    const uint16_t packedMove = TranspositionTable::packMove(move);
+    if (ply < MAX_PLY && killers[ply][0] != packedMove)
+    {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = packedMove;
+    }
+    if (previous.isValid())
+        counterMoves[int(previous.from[0])][int(previous.to[0])] = packedMove;
+
+    // Deep cutoffs are rarer and tell more about the move.
+    const int bonus = std::min(depth * depth, MAX_HISTORY / 16);
+    updateHistory(player, move, bonus);
+    for (int i = 0; i < failedCount; i++)
+    {
+        updateHistory(player, failedQuiets[i], -bonus);
+    }
+}
+
+void MoveOrdering::updateHistory(Color player, const Move& move, int bonus)
+{
+    // The closer the value is to the limit, the less it moves towards it, so it never leaves the range.
+    int& value = historyTable[int(player)][int(move.from[0])][int(move.to[0])];
+    value += bonus - value * std::abs(bonus) / MAX_HISTORY;
+}
+
+MovePicker::MovePicker(const Board& board, std::vector<Move>& moves, uint16_t hashMove, const MoveOrdering& ordering,
+    int ply, const Move& previous)
+    : board(board)
+    , moves(moves)
+    , ordering(ordering)
+    , hashMove(hashMove)
+{
+    assert(moves.size() <= MAX_MOVES && "Too many moves for the picker.");
+    specialQuiets[0] = ordering.killer(ply, 0);
+    specialQuiets[1] = ordering.killer(ply, 1);
+    specialQuiets[2] = ordering.counterMove(previous);
+    // The countermove may be one of the killers, and the hash move any of them.
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < i; j++)
+        {
+            if (specialQuiets[i] == specialQuiets[j])
+                specialQuiets[i] = 0u;
+        }
+        if (specialQuiets[i] == hashMove)
+            specialQuiets[i] = 0u;
+    }
+}
+
+bool MovePicker::next(Move& move)
+{
+    while (true)
+    {
+        switch (stage)
+        {
+        case Stage::HASH_MOVE:
+            stage = Stage::SCORE_CAPTURES;
+            if (hashMove == 0u)
+                break;
+            for (size_t i = 0u; i < moves.size(); i++)
+            {
+                // A colliding key could bring a move of another position, it is only used if it's legal here.
+                if (TranspositionTable::matchesMove(hashMove, moves[i]))
+                {
+                    std::swap(moves[0], moves[i]);
+                    move = moves[cursor++];
+                    return true;
+                }
+            }
+            break;
+
+        case Stage::SCORE_CAPTURES:
+            // The captures and promotions are gathered to the front of the remaining moves.
+            captureEnd = cursor;
+            for (size_t i = cursor; i < moves.size(); i++)
+            {
+                if (!isQuiet(board, moves[i]))
+                    std::swap(moves[captureEnd++], moves[i]);
+            }
+            for (size_t i = cursor; i < captureEnd; i++)
+            {
+                scores[i] = mvvLvaScore(board, moves[i]) + (board.seeGE(moves[i], 0.0f) ? GOOD_CAPTURE_SCORE : 0);
+            }
+            stage = Stage::GOOD_CAPTURES;
+            break;
+
+        case Stage::GOOD_CAPTURES:
+            if (cursor < captureEnd)
+            {
+                selectBest(cursor, captureEnd);
+                if (scores[cursor] >= GOOD_CAPTURE_SCORE)
+                {
+                    move = moves[cursor++];
+                    return true;
+                }
+            }
+            // The rest lose material, they wait until the end.
+            badCaptureCursor = cursor;
+            cursor = captureEnd;
+            stage = Stage::SPECIAL_QUIETS;
+            break;
+
+        case Stage::SPECIAL_QUIETS:
+            while (specialIdx < 3)
+            {
+                const uint16_t special = specialQuiets[specialIdx++];
+                if (special != 0u && selectQuiet(special))
+                {
+                    move = moves[cursor++];
+                    return true;
+                }
+            }
+            stage = Stage::SCORE_QUIETS;
+            break;
+
+        case Stage::SCORE_QUIETS:
+            for (size_t i = cursor; i < moves.size(); i++)
+            {
+                scores[i] = ordering.history(board.getCurrentPlayer(), moves[i]);
+            }
+            stage = Stage::QUIETS;
+            break;
+
+        case Stage::QUIETS:
+            if (cursor < moves.size())
+            {
+                selectBest(cursor, moves.size());
+                move = moves[cursor++];
+                return true;
+            }
+            stage = Stage::BAD_CAPTURES;
+            break;
+
+        case Stage::BAD_CAPTURES:
+            if (badCaptureCursor < captureEnd)
+            {
+                selectBest(badCaptureCursor, captureEnd);
+                move = moves[badCaptureCursor++];
+                return true;
+            }
+            stage = Stage::DONE;
+            break;
+
+        case Stage::DONE:
+            return false;
+        }
+    }
+}
+
+void MovePicker::selectBest(size_t begin, size_t end)
+{
+    size_t best = begin;
+    for (size_t i = begin + 1u; i < end; i++)
+    {
+        if (scores[i] > scores[best])
+            best = i;
+    }
+    std::swap(moves[begin], moves[best]);
+    std::swap(scores[begin], scores[best]);
+}
+
+bool MovePicker::selectQuiet(uint16_t packedMove)
+{
+    for (size_t i = cursor; i < moves.size(); i++)
+    {
+        if (TranspositionTable::matchesMove(packedMove, moves[i]))
+        {
+            // The quiet moves haven't been scored yet.
+            std::swap(moves[cursor], moves[i]);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../Board.h"
+#include "../Move.h"
+
+// Statistics of the moves that caused beta cutoffs, used to order the quiet moves. Each search thread keeps its own.
+// The moves are packed as in the transposition table.
+class MoveOrdering
+{
+public:
+    static constexpr int MAX_PLY = 128;
+
+    MoveOrdering();
+
+    void clear();
+    // Keeps the history of the earlier searches, with less weight. The killers belong to the old positions.
+    void newSearch();
+    uint16_t killer(int ply, int slot) const;
+    // The quiet move that last refuted the previous move.
+    uint16_t counterMove(const Move& previous) const;
+    int history(Color player, const Move& move) const;
+    // A quiet move caused a beta cutoff. The quiet moves searched before it in vain become less likely.
+    void updateQuietCutoff(Color player, int ply, int depth, const Move& move, const Move& previous,
+        const Move* failedQuiets, int failedCount);
+
+private:
+    // The history values stay within plus and minus this.
+    static constexpr int MAX_HISTORY = 16384;
+
+    void updateHistory(Color player, const Move& move, int bonus);
+
+    uint16_t killers[MAX_PLY][2];
+    // By the squares of the previous move.
+    uint16_t counterMoves[64][64];
+    // Butterfly table by the player and the squares of the move.
+    int historyTable[2][64][64];
+};
+
+// Hands out the legal moves of a position in stages, so that a cutoff by an early move saves ordering the rest:
+// the move from the transposition table, captures not losing material by the most valuable victim,
+// killers and the countermove, the other quiet moves by their history, and last the losing captures.
+class MovePicker
+{
+public:
+    // Reorders the given moves while picking them. The list must stay untouched until the picker is done.
+    MovePicker(const Board& board, std::vector<Move>& moves, uint16_t hashMove, const MoveOrdering& ordering,
+        int ply, const Move& previous);
+
+    // False once all the moves have been picked.
+    bool next(Move& move);
+
+    // A position has at most 218 legal moves.
+    static constexpr size_t MAX_MOVES = 256u;
+
+private:
+    enum class Stage : uint8_t
+    {
+        HASH_MOVE, SCORE_CAPTURES, GOOD_CAPTURES, SPECIAL_QUIETS, SCORE_QUIETS, QUIETS, BAD_CAPTURES, DONE
+    };
+
+    // Moves the move with the highest score in the range to its start.
+    void selectBest(size_t begin, size_t end);
+    // Moves a quiet move matching the packed one to the cursor, false if there's none.
+    bool selectQuiet(uint16_t packedMove);
+
+    const Board& board;
+    std::vector<Move>& moves;
+    const MoveOrdering& ordering;
+    uint16_t hashMove;
+    // Killers and the countermove, searched right after the good captures. Zero for none or a duplicate.
+    uint16_t specialQuiets[3];
+    int specialIdx = 0;
+    Stage stage = Stage::HASH_MOVE;
+    size_t cursor = 0u;
+    size_t captureEnd = 0u;
+    size_t badCaptureCursor = 0u;
+    int scores[MAX_MOVES];
+};
@@ -0,0 +1,170 @@
+#include "TranspositionTable.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace
+{
+    constexpr uint8_t AGE_MASK = 0x3f;
+    // An entry this many searches older counts as much as one this many plies shallower.
+    constexpr int AGE_WEIGHT = 8;
+
+    uint16_t promotionCode(Piece promotion)
+    {
+        switch (promotion & ~Piece::COLOR_MASK)
+        {
+        case Piece::KNIGHT: return 1u;
+        case Piece::BISHOP: return 2u;
+        case Piece::ROOK: return 3u;
+        case Piece::QUEEN: return 4u;
+        default: return 0u;
+        }
+    }
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes)
+{
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes)
+{
+    const size_t maxBuckets = std::max(size_t(1u), megabytes * 1024u * 1024u / sizeof(Bucket));
+    size_t bucketCount = 1u;
+    while (bucketCount * 2u <= maxBuckets)
+        bucketCount *= 2u;
+    buckets.reset(new Bucket[bucketCount]());
+    bucketMask = bucketCount - 1u;
+    age = 0u;
+}
+
+void TranspositionTable::clear()
+{
+    for (uint64_t i = 0u; i <= bucketMask; i++)
+    {
+        for (Entry& entry : buckets[i].entries)
+        {
+            entry.keyXorData.store(0u, std::memory_order_relaxed);
+            entry.data.store(0u, std::memory_order_relaxed);
+        }
+    }
+    age = 0u;
+}
+
+void TranspositionTable::newSearch()
+{
+    age = (age + 1u) & AGE_MASK;
+}
+
+bool TranspositionTable::probe(uint64_t key, TranspositionEntry& entry) const
+{
+    const Bucket& bucket = buckets[key & bucketMask];
+    for (const Entry& candidate : bucket.entries)
+    {
+        const uint64_t data = candidate.data.load(std::memory_order_relaxed);
+        if ((candidate.keyXorData.load(std::memory_order_relaxed) ^ data) != key)
+            continue;
+        entry = unpackData(data);
+        return entry.bound != ScoreBound::NONE;
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, int score, unsigned int depth, ScoreBound bound, uint16_t move)
+{
+    Bucket& bucket = buckets[key & bucketMask];
+    Entry* replaced = nullptr;
+    int lowestValue = INT_MAX;
+    for (Entry& candidate : bucket.entries)
+    {
+        const uint64_t data = candidate.data.load(std::memory_order_relaxed);
+        if ((candidate.keyXorData.load(std::memory_order_relaxed) ^ data) == key)
+        {
+            const TranspositionEntry previous = unpackData(data);
+            // A deeper result of this search is worth more than a bound from a shallower one.
+            if (dataAge(data) == age && previous.depth > depth && bound != ScoreBound::EXACT)
+                return;
+            if (move == 0u)
+                move = previous.move;
+            replaced = &candidate;
+            break;
+        }
+        const int value = replacementValue(data);
+        if (value < lowestValue)
+        {
+            lowestValue = value;
+            replaced = &candidate;
+        }
+    }
+
+    const uint64_t data = packData(score, depth, bound, move, age);
+    replaced->keyXorData.store(key ^ data, std::memory_order_relaxed);
+    replaced->data.store(data, std::memory_order_relaxed);
+}
+
+unsigned int TranspositionTable::usagePermille() const
+{
+    const uint64_t sampledBuckets = std::min<uint64_t>(bucketMask + 1u, 1000u);
+    unsigned int used = 0u;
+    for (uint64_t i = 0u; i < sampledBuckets; i++)
+    {
+        for (const Entry& entry : buckets[i].entries)
+        {
+            const uint64_t data = entry.data.load(std::memory_order_relaxed);
+            if (unpackData(data).bound != ScoreBound::NONE && dataAge(data) == age)
+                used++;
+        }
+    }
+    return unsigned(used * 1000u / (sampledBuckets * Bucket::ENTRIES));
+}
+
+size_t TranspositionTable::entryCount() const
+{
+    return size_t(bucketMask + 1u) * Bucket::ENTRIES;
+}
+
+uint16_t TranspositionTable::packMove(const Move& move)
+{
+    if (!move.isValid())
+        return 0u;
+    // The highest bit tells a move from no move, a1a1 would otherwise pack to zero.
+    return uint16_t(0x8000u | (promotionCode(move.promotion) << 12) | (uint16_t(move.from[0]) << 6) | uint16_t(move.to[0]));
+}
+
+bool TranspositionTable::matchesMove(uint16_t packedMove, const Move& move)
+{
+    return packedMove != 0u && packMove(move) == packedMove;
+}
+
+uint64_t TranspositionTable::packData(int score, unsigned int depth, ScoreBound bound, uint16_t move, uint8_t age)
+{
+    return uint64_t(uint32_t(score))
+        | (uint64_t(move) << 32)
+        | (uint64_t(std::min(depth, 255u)) << 48)
+        | (uint64_t(bound) << 56)
+        | (uint64_t(age) << 58);
+}
+
+TranspositionEntry TranspositionTable::unpackData(uint64_t data)
+{
+    TranspositionEntry entry;
+    entry.score = int(uint32_t(data));
+    entry.move = uint16_t(data >> 32);
+    entry.depth = unsigned((data >> 48) & 0xff);
+    entry.bound = ScoreBound((data >> 56) & 0x3);
+    return entry;
+}
+
+uint8_t TranspositionTable::dataAge(uint64_t data)
+{
+    return uint8_t(data >> 58);
+}
+
+int TranspositionTable::replacementValue(uint64_t data) const
+{
+    const TranspositionEntry entry = unpackData(data);
+    if (entry.bound == ScoreBound::NONE)
+        return INT_MIN;
+    const int searchesOld = (age - dataAge(data)) & AGE_MASK;
+    return int(entry.depth) - AGE_WEIGHT * searchesOld;
+}
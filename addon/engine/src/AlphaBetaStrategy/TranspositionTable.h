@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "../Move.h"
+
+// How the stored score relates to the true score of the position.
+enum class ScoreBound : uint8_t
+{
+    NONE, UPPER, LOWER, EXACT
+};
+
+// Result of a search stored for a position.
+struct TranspositionEntry
+{
+    int score = 0;
+    unsigned int depth = 0u;
+    ScoreBound bound = ScoreBound::NONE;
+    // Packed with TranspositionTable::packMove, zero when there is no move.
+    uint16_t move = 0u;
+};
+
+// Fixed-size hash table of search results, keyed by the Zobrist hashes of the positions. The table is shared by
+// the search threads without locks: every entry is two 64-bit words, the key is stored XORed with the data, so
+// an entry torn by a concurrent write doesn't match any key and reads as a miss.
+class TranspositionTable
+{
+public:
+    explicit TranspositionTable(size_t megabytes);
+
+    // Drops all the entries and reallocates the table. Rounded down to a power of two buckets.
+    void resize(size_t megabytes);
+    void clear();
+    // Starts a new search. Entries from the earlier searches are replaced first.
+    void newSearch();
+    bool probe(uint64_t key, TranspositionEntry& entry) const;
+    void store(uint64_t key, int score, unsigned int depth, ScoreBound bound, uint16_t move);
+    // Share of the entries written by the current search, in permille. Sampled from the start of the table.
+    unsigned int usagePermille() const;
+    size_t entryCount() const;
+
+    // The move doesn't identify a castling completely, it is matched against the legal moves of the position.
+    static uint16_t packMove(const Move& move);
+    static bool matchesMove(uint16_t packedMove, const Move& move);
+
+private:
+    struct Entry
+    {
+        std::atomic<uint64_t> keyXorData;
+        std::atomic<uint64_t> data;
+    };
+
+    // One cache line, all the entries a position can be stored in are read with a single memory access.
+    struct alignas(64) Bucket
+    {
+        static constexpr int ENTRIES = 4;
+        Entry entries[ENTRIES];
+    };
+
+    static uint64_t packData(int score, unsigned int depth, ScoreBound bound, uint16_t move, uint8_t age);
+    static TranspositionEntry unpackData(uint64_t data);
+    static uint8_t dataAge(uint64_t data);
+    // Lower values are replaced first: shallow entries and the entries of old searches.
+    int replacementValue(uint64_t data) const;
+
+    std::unique_ptr<Bucket[]> buckets;
+    uint64_t bucketMask = 0u;
+    // Six bits, wraps around.
+    uint8_t age = 0u;
+};
@@ -3,16 +3,29 @@
 #include <algorithm>
 #include <assert.h>
 #include <climits>
+#include <cstdlib>
 #include <iterator>
 #include <sstream>
 #include <unordered_set>
 #include <utility>
 
+#include "BoardEvaluator.h"
 #include "BoardFuncs.h"
 #include "Random.h"
 #include "ScopedProfiler.h"
 #include "StringUtil.h"
 
+namespace
+{
+    // A king may take part in an exchange, but it can't be given away like the other pieces.
+    constexpr float SEE_KING_VALUE = 100.0f;
+
+    float seeValue(Piece piece)
+    {
+        return (piece & ~Piece::COLOR_MASK) == Piece::KING ? SEE_KING_VALUE : BoardEvaluator::pieceValue(piece);
+    }
+}
+
 Board::Board()
 {
     // Set up the standard variation board.
@@ -167,17 +180,24 @@ Board Board::buildFromFEN(const std::string& fenString)
 
 std::vector<Move> Board::findPossibleMoves() const
 {
-    //PROFILE("Board::findPossibleMoves");
-
     std::vector<Move> moves;
     moves.reserve(64);
+    findPossibleMoves(moves);
+    return moves;
+}
+
+void Board::findPossibleMoves(std::vector<Move>& moves) const
+{
+    //PROFILE("Board::findPossibleMoves");
+
+    moves.clear();
     Piece currentPlayerColor = playerInTurn == Color::WHITE ? Piece::WHITE : Piece::BLACK;
     Piece opponentPieceColor = ~currentPlayerColor & Piece::COLOR_MASK;
     char kingSquare = findSquareWithPiece(currentPlayerColor | Piece::KING);
     assert(kingSquare >= 0 && kingSquare < 64 && "King must be on the board.");
 
     bool specialTreatmentSquares[64];
-    for (int i = 0; i < 63; i++)
+    for (int i = 0; i < 64; i++)
         specialTreatmentSquares[i] = false;
 
     specialTreatmentSquares[kingSquare] = true;
@@ -244,18 +264,20 @@ std::vector<Move> Board::findPossibleMoves() const
         std::vector<Move> candidateKingMoves;
         candidateKingMoves.reserve(8);
         findPseudoKingMoves(kingSquare, playerInTurn, candidateKingMoves, false);
-        Color opponentColor = playerInTurn == Color::WHITE ? Color::BLACK : Color::WHITE; 
         for (const Move& move : candidateKingMoves)
         {
-            if (!isThreatened(move.to[0], opponentColor))
+            // The king itself may hide the target square from a slider checking along the same line.
+            if (checkKingMoveLegality(move))
             {
                 moves.push_back(move);
             }
         }
-        return moves;
+        return;
     }
     
-    std::vector<Move> candidateMoves;
+    // Kept between the calls so that generating the moves into a reused buffer doesn't allocate.
+    static thread_local std::vector<Move> candidateMoves;
+    candidateMoves.clear();
     const bool isCheck = checkingPieces.size() > 0;
     for (char square = 0; square < 64; square++)
     {
@@ -270,8 +292,200 @@ std::vector<Move> Board::findPossibleMoves() const
             moves.push_back(move);
         }
     }
+}
 
-    return moves;
+void Board::findCaptureMoves(std::vector<Move>& moves) const
+{
+    moves.clear();
+    Piece currentPlayerColor = playerInTurn == Color::WHITE ? Piece::WHITE : Piece::BLACK;
+    Color opponentColor = playerInTurn == Color::WHITE ? Color::BLACK : Color::WHITE;
+    char kingSquare = findSquareWithPiece(currentPlayerColor | Piece::KING);
+    assert(kingSquare >= 0 && kingSquare < 64 && "King must be on the board.");
+    const bool inCheck = isThreatened(kingSquare, opponentColor);
+
+    static thread_local std::vector<Move> pseudoMoves;
+    pseudoMoves.clear();
+    for (char square = 0; square < 64; square++)
+    {
+        if (!(pieces[square] & currentPlayerColor))
+            continue;
+        if ((pieces[square] & ~Piece::COLOR_MASK) == Piece::PAWN)
+        {
+            findPseudoPawnMoves(square, playerInTurn, pseudoMoves, true);
+            // A promotion is worth searching even when it doesn't capture.
+            MoveDirection forward = playerInTurn == Color::WHITE ? MoveDirection::N : MoveDirection::S;
+            char nextSquare = stepSquareInDirection(square, forward);
+            if ((nextSquare < 8 || nextSquare >= 7 * 8) && pieces[nextSquare] == Piece::NONE)
+                pseudoMoves.push_back(Move(square, nextSquare, Piece::QUEEN));
+        }
+        else
+        {
+            // Only the moves onto the opponent's pieces are generated, castling never captures.
+            switch (pieces[square] & ~Piece::COLOR_MASK)
+            {
+            case Piece::ROOK:
+                findPseudoRookMoves(square, pseudoMoves, true);
+                break;
+            case Piece::QUEEN:
+                findPseudoQueenMoves(square, pseudoMoves, true);
+                break;
+            case Piece::KING:
+                findPseudoKingMoves(square, playerInTurn, pseudoMoves, false, true);
+                break;
+            case Piece::BISHOP:
+                findPseudoBishopMoves(square, pseudoMoves, true);
+                break;
+            case Piece::KNIGHT:
+                findPseudoKnightMoves(square, pseudoMoves, true);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    for (const Move& move : pseudoMoves)
+    {
+        if (move.isPromotion() && move.promotion != Piece::QUEEN)
+            continue;
+        if (inCheck ? checkMoveLegality(move) : checkMoveLegalityOutOfCheck(move, kingSquare))
+            moves.push_back(move);
+    }
+}
+
+bool Board::findRandomMove(Move& move) const
+{
+    // Upper bounds of the pseudo-legal moves per piece type: pawns with promotions, knight, bishop, rook, queen, king with castling.
+    constexpr unsigned int PROMOTING_PAWN_MAX_MOVES = 12u;
+    constexpr unsigned int PAWN_MAX_MOVES = 4u;
+    constexpr unsigned int KNIGHT_MAX_MOVES = 8u;
+    constexpr unsigned int BISHOP_MAX_MOVES = 13u;
+    constexpr unsigned int ROOK_MAX_MOVES = 14u;
+    constexpr unsigned int QUEEN_MAX_MOVES = 27u;
+    constexpr unsigned int KING_MAX_MOVES = 10u;
+    // After this many rejected samples all the moves are generated, which also finds out if there are none.
+    constexpr int MAX_SAMPLING_ATTEMPTS = 32;
+
+    Piece currentPlayerColor = playerInTurn == Color::WHITE ? Piece::WHITE : Piece::BLACK;
+    Color opponentColor = playerInTurn == Color::WHITE ? Color::BLACK : Color::WHITE;
+    char kingSquare = findSquareWithPiece(currentPlayerColor | Piece::KING);
+    assert(kingSquare >= 0 && kingSquare < 64 && "King must be on the board.");
+
+    // In check most pseudo-legal moves are illegal, generating the legal ones is faster.
+    if (!isThreatened(kingSquare, opponentColor))
+    {
+        // A piece is picked with a probability proportional to the upper bound of its moves, then a number below
+        // the bound. The sample is rejected if there's no move with that number. That way every pseudo-legal move
+        // has the same chance, and rejecting the illegal ones keeps the distribution uniform among the legal moves.
+        char pieceSquares[16];
+        unsigned int cumulativeBounds[16];
+        int pieceCount = 0;
+        unsigned int totalBound = 0u;
+        // A player can't have more than 16 pieces in a game, only a hand-made position can. Those skip the sampling.
+        bool tooManyPieces = false;
+        for (char square = 0; square < 64; square++)
+        {
+            if (!(pieces[square] & currentPlayerColor))
+                continue;
+            if (pieceCount == 16)
+            {
+                tooManyPieces = true;
+                break;
+            }
+
+            unsigned int bound = 0u;
+            switch (pieces[square] & ~Piece::COLOR_MASK)
+            {
+            case Piece::PAWN:
+                bound = (square / 8 == 1 && playerInTurn == Color::BLACK) || (square / 8 == 6 && playerInTurn == Color::WHITE)
+                    ? PROMOTING_PAWN_MAX_MOVES : PAWN_MAX_MOVES;
+                break;
+            case Piece::KNIGHT: bound = KNIGHT_MAX_MOVES; break;
+            case Piece::BISHOP: bound = BISHOP_MAX_MOVES; break;
+            case Piece::ROOK: bound = ROOK_MAX_MOVES; break;
+            case Piece::QUEEN: bound = QUEEN_MAX_MOVES; break;
+            case Piece::KING: bound = KING_MAX_MOVES; break;
+            default: break;
+            }
+            totalBound += bound;
+            pieceSquares[pieceCount] = square;
+            cumulativeBounds[pieceCount++] = totalBound;
+        }
+
+        static thread_local std::vector<Move> pieceMoves;
+        for (int attempt = 0; !tooManyPieces && attempt < MAX_SAMPLING_ATTEMPTS; attempt++)
+        {
+            unsigned int sample = Random::Range(0u, totalBound - 1u);
+            int pieceIdx = 0;
+            while (sample >= cumulativeBounds[pieceIdx])
+                pieceIdx++;
+            const unsigned int pieceBound = cumulativeBounds[pieceIdx] - (pieceIdx > 0 ? cumulativeBounds[pieceIdx - 1] : 0u);
+            const unsigned int moveIdx = sample - (cumulativeBounds[pieceIdx] - pieceBound);
+
+            pieceMoves.clear();
+            findPseudoLegalMoves(pieceSquares[pieceIdx], playerInTurn, pieceMoves);
+            assert(pieceMoves.size() <= pieceBound);
+            if (moveIdx >= pieceMoves.size())
+                continue;
+            if (checkMoveLegalityOutOfCheck(pieceMoves[moveIdx], kingSquare))
+            {
+                move = pieceMoves[moveIdx];
+                return true;
+            }
+        }
+    }
+
+    // Conditioned on success the rejection sampling is exactly uniform, and so is this.
+    std::vector<Move> moves = findPossibleMoves();
+    if (moves.size() == 0)
+        return false;
+    move = moves[Random::Range(0, (int)moves.size() - 1)];
+    return true;
+}
+
+bool Board::checkMoveLegalityOutOfCheck(const Move& move, char kingSquare) const
+{
+    // Castling and en passant are rare enough to be tested on a copy of the board.
+    if (move.isCastling() || move.from[1] != -1)
+        return checkMoveLegality(move);
+
+    Color opponentColor = playerInTurn == Color::WHITE ? Color::BLACK : Color::WHITE;
+    // The king isn't in check, so no sliding piece can threaten the target square through the king.
+    if (move.from[0] == kingSquare)
+        return !isThreatened(move.to[0], opponentColor);
+
+    // Any other piece may only leave the line from the king to a piece pinning it.
+    const char pinDirection = directionBetween(kingSquare, move.from[0]);
+    if (pinDirection == 0)
+        return true;
+    char square = stepSquareInDirection(kingSquare, MoveDirection(pinDirection));
+    while (square != move.from[0])
+    {
+        if (pieces[square] != Piece::NONE)
+            return true;
+        square = stepSquareInDirection(square, MoveDirection(pinDirection));
+    }
+    char pinningSquare;
+    Piece pinningPiece = findPieceInDirection(move.from[0], MoveDirection(pinDirection), &pinningSquare);
+    if (pinningPiece == Piece::NONE || areSameColor(pinningPiece, pieces[kingSquare]))
+        return true;
+
+    const Piece pinningType = pinningPiece & ~Piece::COLOR_MASK;
+    const bool isDiagonal = pinDirection == char(MoveDirection::NE) || pinDirection == char(MoveDirection::NW) ||
+        pinDirection == char(MoveDirection::SE) || pinDirection == char(MoveDirection::SW);
+    const bool pins = pinningType == Piece::QUEEN || pinningType == (isDiagonal ? Piece::BISHOP : Piece::ROOK);
+    return !pins || directionBetween(kingSquare, move.to[0]) == pinDirection;
+}
+
+char Board::directionBetween(char fromSquare, char toSquare)
+{
+    const int fileDelta = toSquare % 8 - fromSquare % 8;
+    const int rankDelta = toSquare / 8 - fromSquare / 8;
+    if (fromSquare == toSquare || (fileDelta != 0 && rankDelta != 0 && std::abs(fileDelta) != std::abs(rankDelta)))
+        return 0;
+    const int fileStep = (fileDelta > 0) - (fileDelta < 0);
+    const int rankStep = (rankDelta > 0) - (rankDelta < 0);
+    return char(rankStep * 8 + fileStep);
 }
 
 void Board::findPinnedPieceMoves(char pinnedPieceSquare, MoveDirection pinDirection, std::vector<Move>& moves) const
@@ -541,7 +755,7 @@ void Board::findPseudoPawnMoves(char square, Color player, std::vector<Move>& mo
     }   
 }
 
-void Board::findDirectionalPseudoMoves(char square, const std::vector<MoveDirection>& directions, std::vector<Move>& moves, int maxSteps) const
+void Board::findDirectionalPseudoMoves(char square, const std::vector<MoveDirection>& directions, std::vector<Move>& moves, int maxSteps, bool onlyCaptures) const
 {
     for (MoveDirection dir : directions) 
     {
@@ -551,7 +765,8 @@ void Board::findDirectionalPseudoMoves(char square, const std::vector<MoveDirect
         {
             if (pieces[nextSquare] == Piece::NONE) 
             {
-                moves.push_back(Move(square, nextSquare));
+                if (!onlyCaptures)
+                    moves.push_back(Move(square, nextSquare));
                 nextSquare = stepSquareInDirection(nextSquare, dir);
                 continue;
             }
@@ -564,20 +779,20 @@ void Board::findDirectionalPseudoMoves(char square, const std::vector<MoveDirect
     }
 }
 
-void Board::findPseudoRookMoves(char square, std::vector<Move>& moves) const
+void Board::findPseudoRookMoves(char square, std::vector<Move>& moves, bool onlyCaptures) const
 {
-    std::vector<MoveDirection> directions {
+    static const std::vector<MoveDirection> directions {
         MoveDirection::N,
         MoveDirection::S,
         MoveDirection::E,
         MoveDirection::W
     };
-    findDirectionalPseudoMoves(square, directions, moves);
+    findDirectionalPseudoMoves(square, directions, moves, 1000000, onlyCaptures);
 }
 
-void Board::findPseudoQueenMoves(char square, std::vector<Move>& moves) const
+void Board::findPseudoQueenMoves(char square, std::vector<Move>& moves, bool onlyCaptures) const
 {
-    std::vector<MoveDirection> directions {
+    static const std::vector<MoveDirection> directions {
         MoveDirection::N,
         MoveDirection::S,
         MoveDirection::E,
@@ -587,7 +802,7 @@ void Board::findPseudoQueenMoves(char square, std::vector<Move>& moves) const
         MoveDirection::SW,
         MoveDirection::NW
     };
-    findDirectionalPseudoMoves(square, directions, moves);
+    findDirectionalPseudoMoves(square, directions, moves, 1000000, onlyCaptures);
 }
 
 void Board::findPseudoCastlingMoves(char square, Color player, std::vector<Move>& moves) const
@@ -641,9 +856,9 @@ void Board::findPseudoCastlingMoves(char square, Color player, std::vector<Move>
     }
 }
 
-void Board::findPseudoKingMoves(char square, Color player, std::vector<Move>& moves, bool includeCastling) const
+void Board::findPseudoKingMoves(char square, Color player, std::vector<Move>& moves, bool includeCastling, bool onlyCaptures) const
 {
-    std::vector<MoveDirection> directions {
+    static const std::vector<MoveDirection> directions {
         MoveDirection::N,
         MoveDirection::S,
         MoveDirection::E,
@@ -653,25 +868,25 @@ void Board::findPseudoKingMoves(char square, Color player, std::vector<Move>& mo
         MoveDirection::SW,
         MoveDirection::NW
     };
-    findDirectionalPseudoMoves(square, directions, moves, 1);
+    findDirectionalPseudoMoves(square, directions, moves, 1, onlyCaptures);
     if (includeCastling)
     {
         findPseudoCastlingMoves(square, player, moves);
     }
 }
 
-void Board::findPseudoBishopMoves(char square, std::vector<Move>& moves) const 
+void Board::findPseudoBishopMoves(char square, std::vector<Move>& moves, bool onlyCaptures) const
 {
-    std::vector<MoveDirection> directions {
+    static const std::vector<MoveDirection> directions {
         MoveDirection::NE,
         MoveDirection::SE,
         MoveDirection::SW,
         MoveDirection::NW
     };
-    findDirectionalPseudoMoves(square, directions, moves);    
+    findDirectionalPseudoMoves(square, directions, moves, 1000000, onlyCaptures);
 }
 
-void Board::findPseudoKnightMoves(char square, std::vector<Move>& moves) const
+void Board::findPseudoKnightMoves(char square, std::vector<Move>& moves, bool onlyCaptures) const
 {
     char file = square % 8;
     char rank = square / 8;
@@ -686,7 +901,7 @@ void Board::findPseudoKnightMoves(char square, std::vector<Move>& moves) const
         
         char moveSquare = 8 * moveRank + moveFile;
         Piece targetSquarePiece = pieces[moveSquare];
-        if (targetSquarePiece == Piece::NONE || !areSameColor(pieces[square], targetSquarePiece))
+        if (targetSquarePiece == Piece::NONE ? !onlyCaptures : !areSameColor(pieces[square], targetSquarePiece))
             moves.push_back(Move(square, moveSquare));
     }
 }
@@ -845,6 +1060,144 @@ bool Board::hasPawnThreat(char square, Color byPlayer) const
     return false;
 }
 
+float Board::see(const Move& move) const
+{
+    if (move.isCastling())
+        return 0.0f;
+
+    // Gains of the captures in the sequence, each from the point of view of the player making it.
+    // A sequence can't be longer than the number of pieces.
+    float gains[32];
+    gains[0] = BoardEvaluator::pieceValue(capturedPiece(move));
+    float pieceOnSquare = seeValue(pieces[move.from[0]]);
+    if (move.isPromotion())
+    {
+        gains[0] += BoardEvaluator::pieceValue(move.promotion) - BoardEvaluator::pieceValue(Piece::PAWN);
+        pieceOnSquare = BoardEvaluator::pieceValue(move.promotion);
+    }
+
+    const char target = move.to[0];
+    uint64_t occupied = 0u;
+    for (char square = 0; square < 64; square++)
+    {
+        if (pieces[square] != Piece::NONE)
+            occupied |= uint64_t(1u) << square;
+    }
+    occupied &= ~(uint64_t(1u) << move.from[0]);
+    // The pawn taken en passant isn't on the target square.
+    if (move.from[1] != -1)
+        occupied &= ~(uint64_t(1u) << move.from[1]);
+
+    Piece side = playerInTurn == Color::WHITE ? Piece::BLACK : Piece::WHITE;
+    int depth = 0;
+    while (depth < 31)
+    {
+        // Taking away a piece from the line may have opened it for a slider behind.
+        const char attacker = leastValuableAttacker(target, side, occupied);
+        if (attacker == -1)
+            break;
+        depth++;
+        gains[depth] = pieceOnSquare - gains[depth - 1];
+        // Neither player can do better by going on, whatever happens next.
+        if (std::max(-gains[depth - 1], gains[depth]) < 0.0f)
+            break;
+        pieceOnSquare = seeValue(pieces[attacker]);
+        occupied &= ~(uint64_t(1u) << attacker);
+        side = ~side & Piece::COLOR_MASK;
+    }
+    // Each player may also stop taking, whichever is better for them.
+    while (depth > 0)
+    {
+        gains[depth - 1] = -std::max(-gains[depth - 1], gains[depth]);
+        depth--;
+    }
+    return gains[0];
+}
+
+bool Board::seeGE(const Move& move, float threshold) const
+{
+    if (move.isCastling())
+        return threshold <= 0.0f;
+    float gain = BoardEvaluator::pieceValue(capturedPiece(move));
+    float mover = seeValue(pieces[move.from[0]]);
+    if (move.isPromotion())
+    {
+        gain += BoardEvaluator::pieceValue(move.promotion) - BoardEvaluator::pieceValue(Piece::PAWN);
+        mover = BoardEvaluator::pieceValue(move.promotion);
+    }
+    // The exchange can't win more than the first capture.
+    if (gain < threshold)
+        return false;
+    // Even losing the moving piece for nothing would be enough.
+    if (gain - mover >= threshold)
+        return true;
+    return see(move) >= threshold;
+}
+
+char Board::leastValuableAttacker(char square, Piece color, uint64_t occupied) const
+{
+    auto isOccupied = [occupied](char sqr) {
+        return !!(occupied & (uint64_t(1u) << sqr));
+    };
+
+    // Pawns attack the square from behind it, as seen from their own side.
+    const MoveDirection pawnSides[2] = {
+        color == Piece::WHITE ? MoveDirection::SW : MoveDirection::NW,
+        color == Piece::WHITE ? MoveDirection::SE : MoveDirection::NE
+    };
+    for (MoveDirection direction : pawnSides)
+    {
+        const char pawnSquare = stepSquareInDirection(square, direction);
+        if (pawnSquare != -1 && isOccupied(pawnSquare) && pieces[pawnSquare] == (color | Piece::PAWN))
+            return pawnSquare;
+    }
+
+    const char file = square % 8;
+    const char rank = square / 8;
+    const char rankOffsets[8] = {  1, 2,2,1,-1,-2,-2,-1 };
+    const char fileOffsets[8] = { -2,-1,1,2, 2, 1,-1,-2 };
+    for (int i = 0; i < 8; i++)
+    {
+        const char knightRank = rank + rankOffsets[i];
+        const char knightFile = file + fileOffsets[i];
+        if (knightRank > 7 || knightRank < 0 || knightFile < 0 || knightFile > 7)
+            continue;
+        const char knightSquare = 8 * knightRank + knightFile;
+        if (isOccupied(knightSquare) && pieces[knightSquare] == (color | Piece::KNIGHT))
+            return knightSquare;
+    }
+
+    // The first piece on each line, the sliders behind it are found once it has been taken away.
+    const MoveDirection directions[8] = {
+        MoveDirection::NE, MoveDirection::SE, MoveDirection::SW, MoveDirection::NW,
+        MoveDirection::N, MoveDirection::S, MoveDirection::E, MoveDirection::W
+    };
+    char bestSquare = -1;
+    float bestValue = SEE_KING_VALUE + 1.0f;
+    for (int i = 0; i < 8; i++)
+    {
+        const bool diagonal = i < 4;
+        char nextSquare = stepSquareInDirection(square, directions[i]);
+        bool adjacent = true;
+        while (nextSquare != -1 && !isOccupied(nextSquare))
+        {
+            nextSquare = stepSquareInDirection(nextSquare, directions[i]);
+            adjacent = false;
+        }
+        if (nextSquare == -1 || !(pieces[nextSquare] & color))
+            continue;
+        const Piece type = pieces[nextSquare] & ~Piece::COLOR_MASK;
+        const bool attacks = type == Piece::QUEEN || type == (diagonal ? Piece::BISHOP : Piece::ROOK)
+            || (type == Piece::KING && adjacent);
+        if (attacks && seeValue(type) < bestValue)
+        {
+            bestValue = seeValue(type);
+            bestSquare = nextSquare;
+        }
+    }
+    return bestSquare;
+}
+
 Move Board::constructPromotionMove(const std::string& moveUCI) const
 {
     const char* moveStr = moveUCI.c_str();
@@ -1050,6 +1403,19 @@ void Board::applyMove(const Move& move)
     updateRepetitionHistory();
 }
 
+void Board::applyNullMove()
+{
+    if (enPassant != -1)
+    {
+        hash.toggleEnPassant(enPassant % 8);
+        enPassant = -1;
+    }
+    playerInTurn = playerInTurn == Color::BLACK ? Color::WHITE : Color::BLACK;
+    hash.togglePlayerInTurn();
+    resetRepetitionHistory();
+    updateRepetitionHistory();
+}
+
 void Board::updateCastlingRights()
 {
     // Update for white
@@ -1149,6 +1515,53 @@ bool Board::isCheck() const
     return isThreatened(kingSquare, opponentColor);
 }
 
+Piece Board::capturedPiece(const Move& move) const
+{
+    if (move.isCastling())
+        return Piece::NONE;
+    // En passant stores the square of the captured pawn in from[1].
+    return pieces[move.from[1] != -1 ? move.from[1] : move.to[0]];
+}
+
+bool Board::givesDirectCheck(const Move& move) const
+{
+    Piece opponentKing = (playerInTurn == Color::WHITE ? Piece::BLACK : Piece::WHITE) | Piece::KING;
+    const char kingSquare = findSquareWithPiece(opponentKing);
+    const char targetSquare = move.to[0];
+    const int fileDelta = std::abs(kingSquare % 8 - targetSquare % 8);
+    const int rankDelta = kingSquare / 8 - targetSquare / 8;
+    const Piece movingPiece = move.isPromotion() ? move.promotion : pieces[move.from[0]] & ~Piece::COLOR_MASK;
+    switch (movingPiece)
+    {
+    case Piece::PAWN:
+        return fileDelta == 1 && rankDelta == (playerInTurn == Color::WHITE ? 1 : -1);
+    case Piece::KNIGHT:
+        return (fileDelta == 1 && std::abs(rankDelta) == 2) || (fileDelta == 2 && std::abs(rankDelta) == 1);
+    case Piece::BISHOP:
+    case Piece::ROOK:
+    case Piece::QUEEN:
+    {
+        const char direction = directionBetween(targetSquare, kingSquare);
+        if (direction == 0)
+            return false;
+        const bool isDiagonal = fileDelta != 0 && rankDelta != 0;
+        if ((movingPiece == Piece::BISHOP && !isDiagonal) || (movingPiece == Piece::ROOK && isDiagonal))
+            return false;
+        // The square the piece leaves is empty after the move.
+        char square = stepSquareInDirection(targetSquare, MoveDirection(direction));
+        while (square != kingSquare)
+        {
+            if (pieces[square] != Piece::NONE && square != move.from[0])
+                return false;
+            square = stepSquareInDirection(square, MoveDirection(direction));
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
 bool Board::isMate() const
 {
     return isCheck() && findPossibleMoves().size() == 0;
@@ -1213,31 +1626,38 @@ bool Board::threefoldRepetition() const
     return highestRepetitionCount >= 3u;
 }   
 
+bool Board::isRepetition() const
+{
+    return currentRepetitionCount >= 2u;
+}
+
 void Board::updateRepetitionHistory()
 {
+    const unsigned int positionHash = (unsigned int)hash.getHash();
     unsigned char repeatCount = 1u;
     if (playerInTurn == Color::WHITE)
     {
         for (int i = 0; i < whitePositionsSize; i++)
         {
-            if (repeatablePositionsWhite[i] == hash.getHash())
+            if (repeatablePositionsWhite[i] == positionHash)
             {
                 repeatCount++;
             }
         }
-        repeatablePositionsWhite[whitePositionsSize++] = hash.getHash();
+        repeatablePositionsWhite[whitePositionsSize++] = positionHash;
     }
     else 
     {
         for (int i = 0; i < blackPositionsSize; i++)
         {
-            if (repeatablePositionsBlack[i] == hash.getHash())
+            if (repeatablePositionsBlack[i] == positionHash)
             {
                 repeatCount++;
             }
         }
-        repeatablePositionsBlack[blackPositionsSize++] = hash.getHash();
+        repeatablePositionsBlack[blackPositionsSize++] = positionHash;
     }
+    currentRepetitionCount = repeatCount;
     highestRepetitionCount = std::max(highestRepetitionCount, repeatCount);
 }
 
@@ -1248,7 +1668,7 @@ void Board::resetRepetitionHistory()
     blackPositionsSize = 0u;
 }
 
-unsigned int Board::getHash()
+uint64_t Board::getHash() const
 {
     return hash.getHash();
 }
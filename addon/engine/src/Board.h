@@ -16,21 +16,44 @@ public:
     static Board buildFromFEN(const std::string& fenString);
 
     std::vector<Move> findPossibleMoves() const;
+    // Same as above, but fills the given list, so a reused list doesn't need to allocate.
+    void findPossibleMoves(std::vector<Move>& moves) const;
+    // Legal captures and queen promotions only, for searching the exchanges at the end of a line.
+    // Under-promotions are left out, they are hardly ever better than promoting to a queen.
+    void findCaptureMoves(std::vector<Move>& moves) const;
+    // Picks a legal move uniformly at random without generating all of them.
+    // Returns false if there are no legal moves, i.e. on checkmate and stalemate.
+    bool findRandomMove(Move& move) const;
     void findPinnedPieceMoves(char pinnedPieceSquare, MoveDirection pinDirection, std::vector<Move> &moves) const;
     Move constructMove(const std::string &moveUCI) const;
     void applyMove(const Move& move);
     void applyMove(const std::string& moveUCI);
+    // Passes the turn to the opponent, for searches testing whether the player's move matters at all.
+    // The pass is irreversible as far as repetitions and the fifty move rule are concerned.
+    void applyNullMove();
     Piece getSquare(char square) const;
     Piece getSquare(const char* sqr) const;
     Piece getSquare(char file, char rank) const;
     Color getCurrentPlayer() const;
     bool isCheck() const;
+    // Piece taken by the move, Piece::NONE for moves that don't capture.
+    Piece capturedPiece(const Move& move) const;
+    // True if the moving piece itself checks the opponent's king after the move. Discovered checks aren't detected.
+    bool givesDirectCheck(const Move& move) const;
+    bool isThreatened(char square, Color byPlayer) const;
+    // Static exchange evaluation: material in pawns the player in turn gains with the move when both players keep
+    // taking on the target square with their least valuable piece for as long as it pays off. Pins are ignored.
+    float see(const Move& move) const;
+    // Same as see(move) >= threshold, but skips the exchange when the first capture decides it.
+    bool seeGE(const Move& move, float threshold) const;
     bool isMate() const;
     bool insufficientMaterial() const;
     bool noProgress() const;
     bool threefoldRepetition() const;
+    // True if the current position has occurred before since the last irreversible move.
+    bool isRepetition() const;
     std::string getFEN() const;
-    unsigned int getHash();
+    uint64_t getHash() const;
 
 private:
     void setSquare(const char* sqr, Piece data);
@@ -44,8 +67,13 @@ private:
     std::vector<char> findKnightThreats(char square, Piece byColor) const;
     bool posesXrayThreat(Piece piece, MoveDirection direction, int distance) const;
     bool checkMoveLegality(const Move &move) const;
+    // Cheaper legality test for a pseudo-legal move when the player in turn is not in check.
+    bool checkMoveLegalityOutOfCheck(const Move& move, char kingSquare) const;
+    // Direction of the line from the first square to the second, zero if they aren't on a common line.
+    static char directionBetween(char fromSquare, char toSquare);
     char findSquareWithPiece(Piece piece) const;
-    bool isThreatened(char square, Color byPlayer) const;
+    // Square of the least valuable piece of the color attacking the square through the occupied squares, -1 if none.
+    char leastValuableAttacker(char square, Piece color, uint64_t occupied) const;
     bool hasPawnThreat(char square, Color byPlayer) const;
     unsigned char turnsSincePawnMoveOrCapture() const;
     static bool areSameColor(Piece p1, Piece p2);
@@ -56,13 +84,14 @@ private:
 
     void findPseudoLegalMoves(char square, Color forPlayer, std::vector<Move>& pseudoMoves, bool pawnOnlyTakes = false, bool forceIncludePawnTakes = false) const;
     void findPseudoPawnMoves(char square, Color player, std::vector<Move>& moves, bool onlyTakes = false, bool forceIncludeTakes = false) const;
-    void findPseudoRookMoves(char square, std::vector<Move>& moves) const;
-    void findPseudoQueenMoves(char square, std::vector<Move>& moves) const;
-    void findPseudoBishopMoves(char square, std::vector<Move>& moves) const;
+    // With onlyCaptures the moves to empty squares are left out.
+    void findPseudoRookMoves(char square, std::vector<Move>& moves, bool onlyCaptures = false) const;
+    void findPseudoQueenMoves(char square, std::vector<Move>& moves, bool onlyCaptures = false) const;
+    void findPseudoBishopMoves(char square, std::vector<Move>& moves, bool onlyCaptures = false) const;
     void findPseudoCastlingMoves(char square, Color player, std::vector<Move>& moves) const;
-    void findPseudoKingMoves(char square, Color player, std::vector<Move>& moves, bool includeCastling = true) const;
-    void findPseudoKnightMoves(char square, std::vector<Move>& moves) const;
-    void findDirectionalPseudoMoves(char square, const std::vector<MoveDirection>& directions, std::vector<Move>& moves, int maxSteps = 1000000) const;
+    void findPseudoKingMoves(char square, Color player, std::vector<Move>& moves, bool includeCastling = true, bool onlyCaptures = false) const;
+    void findPseudoKnightMoves(char square, std::vector<Move>& moves, bool onlyCaptures = false) const;
+    void findDirectionalPseudoMoves(char square, const std::vector<MoveDirection>& directions, std::vector<Move>& moves, int maxSteps = 1000000, bool onlyCaptures = false) const;
 
     void updateRepetitionHistory();
     void resetRepetitionHistory();
@@ -84,6 +113,7 @@ private:
 
     ZobristHash hash;
     
+    // The repetition history only keeps the lower half of the hash to keep the board cheap to copy.
     unsigned int repeatablePositionsWhite[50];
     unsigned char whitePositionsSize = 0u;
 
@@ -91,4 +121,5 @@ private:
     unsigned char blackPositionsSize = 0u;
     
     unsigned char highestRepetitionCount = 0u;
+    unsigned char currentRepetitionCount = 0u;
 };
\ No newline at end of file
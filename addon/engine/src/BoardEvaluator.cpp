@@ -1,19 +1,92 @@
-#include <unordered_map>
+#include <algorithm>
+#include <vector>
 
 #include "Board.h"
+#include "BoardEvaluator.h"
 #include "Piece.h"
 
-namespace BoardEvaluator
+namespace
 {
-    std::unordered_map<Piece, float> pieceValues = {
-        { Piece::PAWN, 1.0f },
-        { Piece::KNIGHT, 3.0f },
-        { Piece::BISHOP, 3.0f },
-        { Piece::ROOK, 5.0f },
-        { Piece::QUEEN, 9.0f },
-        { Piece::KING, 0.0f }
-    };
+    // A capture that can't raise the score to alpha even with this much positional gain isn't searched.
+    constexpr float DELTA_MARGIN = 2.0f;
+
+    // Material the move wins right away, not counting what the opponent may take back.
+    float materialGain(const Board& board, const Move& move)
+    {
+        float gain = BoardEvaluator::pieceValue(board.capturedPiece(move));
+        if (move.isPromotion())
+            gain += BoardEvaluator::pieceValue(move.promotion) - BoardEvaluator::pieceValue(Piece::PAWN);
+        return gain;
+    }
+
+    // Capture-only alpha-beta search. The result is from the point of view of the player in turn.
+    // In check all the evasions are searched, as standing pat isn't an option then.
+    // The ply counts the moves from the root of the search, the mates found are that much less than MATED.
+    float quiescence(const Board& board, float alpha, float beta, unsigned int depth, unsigned int ply, uint64_t* nodeCount)
+    {
+        if (nodeCount)
+            (*nodeCount)++;
+        const float standPat = BoardEvaluator::evaluateBoard(board) * (board.getCurrentPlayer() == Color::WHITE ? 1.0f : -1.0f);
+        if (depth == 0u)
+            return standPat;
+        const bool inCheck = board.isCheck();
+        if (!inCheck)
+        {
+            if (standPat >= beta)
+                return standPat;
+            alpha = std::max(alpha, standPat);
+        }
+
+        // One buffer per depth, so the moves of the parent stay intact while the children are searched.
+        static thread_local std::vector<std::vector<Move>> moveBuffers;
+        if (moveBuffers.size() < depth)
+            moveBuffers.resize(depth);
+        std::vector<Move>& moves = moveBuffers[depth - 1u];
+        if (inCheck)
+        {
+            board.findPossibleMoves(moves);
+            if (moves.size() == 0u)
+                return BoardEvaluator::MATED + ply;
+        }
+        else
+        {
+            board.findCaptureMoves(moves);
+        }
+        // Most valuable victims first, they are the most likely to cause a cutoff. Cheaper attackers first among them.
+        std::sort(moves.begin(), moves.end(), [&board](const Move& a, const Move& b) {
+            const float gainA = materialGain(board, a);
+            const float gainB = materialGain(board, b);
+            if (gainA != gainB)
+                return gainA > gainB;
+            return BoardEvaluator::pieceValue(board.getSquare(a.from[0])) < BoardEvaluator::pieceValue(board.getSquare(b.from[0]));
+        });
+
+        float bestScore = inCheck ? BoardEvaluator::MATED + ply : standPat;
+        for (const Move& move : moves)
+        {
+            if (!inCheck)
+            {
+                // Delta pruning: the capture can't make up for how far behind alpha the position is.
+                if (standPat + materialGain(board, move) + DELTA_MARGIN <= alpha)
+                    continue;
+                // Losing captures are left out, the exchange on the square would only lose material.
+                if (!board.seeGE(move, 0.0f))
+                    continue;
+            }
+            Board next = board;
+            next.applyMove(move);
+            const float score = -quiescence(next, -beta, -alpha, depth - 1u, ply + 1u, nodeCount);
+            if (score >= beta)
+                return score;
+            bestScore = std::max(bestScore, score);
+            alpha = std::max(alpha, score);
+        }
+        return bestScore;
+    }
+}
 
+namespace BoardEvaluator
+{
     float evaluateBoard(const Board& board)
     {
         float evaluation = 0.0f;
@@ -23,11 +96,35 @@ namespace BoardEvaluator
             if (piece == Piece::NONE)
                 continue;
 
-            float pieceValue = pieceValues[piece & ~Piece::COLOR_MASK];
+            float value = pieceValue(piece);
             if (!!(piece & Piece::BLACK))
-                pieceValue *= -1.0f;
-            evaluation += pieceValue;
+                value *= -1.0f;
+            evaluation += value;
         }
         return evaluation;
     }
-}
\ No newline at end of file
+
+    float pieceValue(Piece piece)
+    {
+        switch (piece & ~Piece::COLOR_MASK)
+        {
+            case Piece::PAWN: return 1.0f;
+            case Piece::KNIGHT: return 3.0f;
+            case Piece::BISHOP: return 3.0f;
+            case Piece::ROOK: return 5.0f;
+            case Piece::QUEEN: return 9.0f;
+            default: return 0.0f;
+        }
+    }
+
+    float evaluateQuiescent(const Board& board, unsigned int maxDepth)
+    {
+        const float evaluation = quiescence(board, 2.0f * MATED, -2.0f * MATED, maxDepth, 0u, nullptr);
+        return board.getCurrentPlayer() == Color::WHITE ? evaluation : -evaluation;
+    }
+
+    float searchQuiescent(const Board& board, float alpha, float beta, unsigned int maxDepth, uint64_t* nodeCount)
+    {
+        return quiescence(board, alpha, beta, maxDepth, 0u, nodeCount);
+    }
+}
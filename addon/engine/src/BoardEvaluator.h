@@ -1,8 +1,26 @@
 #pragma once
 
+#include <cstdint>
+
+#include "Piece.h"
+
 class Board;
 
 namespace BoardEvaluator
 {
+    // Material balance in pawns, positive when white is ahead.
     float evaluateBoard(const Board& board);
-}
\ No newline at end of file
+    // Value of the piece in pawns regardless of its color. Kings are worth nothing.
+    float pieceValue(Piece piece);
+    // Plays out the captures of the position before evaluating it, so that the result isn't taken in the middle
+    // of an exchange. Searches at most maxDepth captures deep. Same scale and point of view as evaluateBoard.
+    float evaluateQuiescent(const Board& board, unsigned int maxDepth);
+    // The search behind evaluateQuiescent with a window, for the searches that have one. The result is from the
+    // point of view of the player in turn and may fall outside the window. The searched positions are added to
+    // the node count if one is given.
+    float searchQuiescent(const Board& board, float alpha, float beta, unsigned int maxDepth, uint64_t* nodeCount = nullptr);
+
+    // Result of a position in check without legal moves, in pawns for the player in turn.
+    // The capture searches add the plies from their root to the mate, so a later mate is a little better.
+    constexpr float MATED = -1000.0f;
+}
@@ -1,5 +1,6 @@
 #include "GreyPawnChess.h"
 
+#include <algorithm>
 #include <assert.h>
 #include <atomic>
 #include <iostream>
@@ -153,6 +154,17 @@ Duration GreyPawnChess::timeSinceStateSet()
     return std::chrono::system_clock::now() - stateSetTime;
 }
 
+Duration GreyPawnChess::moveTimeLeft()
+{
+    if (playerInTurn() != myColor)
+        return Duration(0.0f);
+
+    const float timeLeftMs = float(myColor == Color::WHITE ? gameState.wTime : gameState.bTime);
+    const float incrementMs = float(myColor == Color::WHITE ? gameState.wIncrement : gameState.bIncrement);
+    const Duration budget(TimeManagement::moveTimeBudgetMs(timeLeftMs, incrementMs, (int)moves.size()) / 1000.0f);
+    return std::max(Duration(0.0f), budget - timeSinceStateSet());
+}
+
 Color GreyPawnChess::playerInTurn() 
 {
     if (gameState.finishedStatus())
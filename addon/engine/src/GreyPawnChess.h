@@ -15,6 +15,7 @@
 class GreyPawnChess 
 {
 public:
+    virtual ~GreyPawnChess() = default;
     // Setup the game
     void setup(char color, int timeMs, int incrementMs, const std::string& setupVariant);
     // Starts calculating the best moves, i.e. playing the match
@@ -37,6 +38,8 @@ protected:
     virtual Move getBestMove() = 0;
 
     Duration timeSinceStateSet();
+    // Thinking time left for the current move as the time management sees it, zero when it's not our turn.
+    Duration moveTimeLeft();
     Color playerInTurn();
     void applyMove(const Move& move);
     void makeComputerMove(const Move& move);
@@ -0,0 +1,84 @@
+#include "LeafPlayoutWorkers.h"
+
+#include <assert.h>
+
+LeafPlayoutWorkers::LeafPlayoutWorkers(unsigned int workerCount)
+    : boards(workerCount)
+    , results(workerCount, 0.0f)
+{
+    for (unsigned int i = 0u; i < workerCount; i++)
+    {
+        threads.emplace_back(&LeafPlayoutWorkers::work, this, i);
+    }
+}
+
+LeafPlayoutWorkers::~LeafPlayoutWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+unsigned int LeafPlayoutWorkers::workerCount() const
+{
+    return unsigned(threads.size());
+}
+
+void LeafPlayoutWorkers::start(const Board& board, unsigned int playoutCount, Playout playout, const MonteCarloSettings& settings)
+{
+    assert(playoutCount <= workerCount() && "More playouts than workers.");
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // The workers not taking part in the batch have nothing to read, they are all waiting.
+        for (unsigned int i = 0u; i < playoutCount; i++)
+        {
+            boards[i] = board;
+        }
+        this->playout = playout;
+        this->settings = &settings;
+        this->playoutCount = playoutCount;
+        pending = playoutCount;
+        batch++;
+    }
+    wakeUp.notify_all();
+}
+
+float LeafPlayoutWorkers::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this]() { return pending == 0u; });
+    float total = 0.0f;
+    for (unsigned int i = 0u; i < playoutCount; i++)
+    {
+        total += results[i];
+    }
+    return total;
+}
+
+void LeafPlayoutWorkers::work(unsigned int index)
+{
+    uint64_t lastBatch = 0u;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        wakeUp.wait(lock, [&]() { return stopping || batch != lastBatch; });
+        if (stopping)
+            return;
+        lastBatch = batch;
+        if (index >= playoutCount)
+            continue;
+
+        // Each worker only touches its own board and result while the playouts run.
+        lock.unlock();
+        results[index] = playout(boards[index], *settings);
+        lock.lock();
+        if (--pending == 0u)
+            finished.notify_one();
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Board.h"
+
+struct MonteCarloSettings;
+
+// Threads that stay alive for the whole search and run the batched playouts of the leaves.
+// A leaf only wakes them instead of starting new threads, which would cost about as much as the playouts.
+// The threads also keep their own move buffers and random state from one leaf to the next.
+class LeafPlayoutWorkers
+{
+public:
+    using Playout = float (*)(Board& board, const MonteCarloSettings& settings);
+
+    explicit LeafPlayoutWorkers(unsigned int workerCount);
+    ~LeafPlayoutWorkers();
+    LeafPlayoutWorkers(const LeafPlayoutWorkers&) = delete;
+    LeafPlayoutWorkers& operator=(const LeafPlayoutWorkers&) = delete;
+
+    unsigned int workerCount() const;
+    // The first playoutCount workers each play out their own copy of the board. Returns without waiting,
+    // the caller can run a playout of its own meanwhile. The settings must stay alive until wait returns.
+    void start(const Board& board, unsigned int playoutCount, Playout playout, const MonteCarloSettings& settings);
+    // Waits for the playouts started last and returns the sum of their results.
+    float wait();
+
+private:
+    void work(unsigned int index);
+
+    std::vector<std::thread> threads;
+    std::vector<Board> boards;
+    std::vector<float> results;
+    Playout playout = nullptr;
+    const MonteCarloSettings* settings = nullptr;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::condition_variable finished;
+    // Counts the batches, so a worker can tell a new batch from a spurious wake up.
+    uint64_t batch = 0u;
+    unsigned int playoutCount = 0u;
+    unsigned int pending = 0u;
+    bool stopping = false;
+};
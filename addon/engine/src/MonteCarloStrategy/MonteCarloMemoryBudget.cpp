@@ -0,0 +1,45 @@
+#include "MonteCarloMemoryBudget.h"
+
+MonteCarloMemoryBudget::MonteCarloMemoryBudget(size_t maxNodes, size_t maxBytes)
+    : maxNodes(maxNodes), maxBytes(maxBytes)
+{
+}
+
+bool MonteCarloMemoryBudget::isLimited() const
+{
+    return maxNodes > 0u || maxBytes > 0u;
+}
+
+bool MonteCarloMemoryBudget::exceeds(float limitFraction) const
+{
+    if (maxNodes > 0u && nodes >= maxNodes * limitFraction)
+        return true;
+    return maxBytes > 0u && bytes >= maxBytes * limitFraction;
+}
+
+bool MonteCarloMemoryBudget::isFull() const
+{
+    return exceeds(1.0f);
+}
+
+void MonteCarloMemoryBudget::add(size_t nodes, size_t bytes)
+{
+    this->nodes += nodes;
+    this->bytes += bytes;
+}
+
+void MonteCarloMemoryBudget::reset(size_t nodes, size_t bytes)
+{
+    this->nodes = nodes;
+    this->bytes = bytes;
+}
+
+size_t MonteCarloMemoryBudget::usedNodes() const
+{
+    return nodes;
+}
+
+size_t MonteCarloMemoryBudget::usedBytes() const
+{
+    return bytes;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+// Keeps an estimate of the memory used by a Monte Carlo tree and limits its growth.
+// The search adds to the estimate as it grows the tree, the owner of the tree resets it
+// from an exact count whenever it releases parts of the tree.
+class MonteCarloMemoryBudget
+{
+public:
+    // A zero limit means that the amount of nodes or bytes is not limited.
+    MonteCarloMemoryBudget(size_t maxNodes = 0u, size_t maxBytes = 0u);
+
+    bool isLimited() const;
+    // True when either usage is at or above the given fraction of its limit.
+    bool exceeds(float limitFraction) const;
+    // The tree must not grow any further when this is true.
+    bool isFull() const;
+    void add(size_t nodes, size_t bytes);
+    void reset(size_t nodes, size_t bytes);
+    size_t usedNodes() const;
+    size_t usedBytes() const;
+
+private:
+    size_t maxNodes;
+    size_t maxBytes;
+    size_t nodes = 0u;
+    size_t bytes = 0u;
+};
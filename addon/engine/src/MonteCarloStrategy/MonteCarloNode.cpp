@@ -1,52 +1,273 @@
 #include "MonteCarloNode.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <bitset>
+#include <cfloat>
 #include <cmath>
 #include <limits>
 #include <iostream>
+#include <unordered_set>
 #include <vector>
 
 #include "../Board.h"
 #include "../BoardEvaluator.h"
 #include "../Random.h"
+#include "LeafPlayoutWorkers.h"
+#include "MonteCarloMemoryBudget.h"
+#include "MonteCarloTranspositionTable.h"
+#include "MovePrior.h"
+#include "PlayoutPolicy.h"
+#include "UCBKernel.h"
+
+namespace
+{
+    // Value of the captured piece minus a fraction of the moving one, plus the promoted piece.
+    // Only used to decide the order in which progressive widening lets the moves in.
+    int captureScore(const Board& board, const Move& move)
+    {
+        auto pieceValue = [](Piece piece) {
+            switch (piece & ~Piece::COLOR_MASK)
+            {
+                case Piece::PAWN: return 100;
+                case Piece::KNIGHT: return 300;
+                case Piece::BISHOP: return 300;
+                case Piece::ROOK: return 500;
+                case Piece::QUEEN: return 900;
+                default: return 0;
+            }
+        };
+        if (move.isCastling())
+            return 0;
+        // En passant stores the captured pawn's square in from[1].
+        const char capturedSquare = move.from[1] != -1 ? move.from[1] : move.to[0];
+        int score = pieceValue(board.getSquare(capturedSquare)) - pieceValue(board.getSquare(move.from[0])) / 10;
+        if (move.isPromotion())
+            score += pieceValue(move.promotion);
+        return score;
+    }
+
+    // Moves each player has made since the node being backed up, for the all-moves-as-first statistics.
+    // Moves are told apart only by their squares, under-promotions count as the same move.
+    class AmafMoves
+    {
+    public:
+        void clear()
+        {
+            played[0].reset();
+            played[1].reset();
+        }
+        void record(Color player, const Move& move)
+        {
+            played[player == Color::WHITE ? 0 : 1].set(key(move));
+        }
+        bool contains(Color player, const Move& move) const
+        {
+            return played[player == Color::WHITE ? 0 : 1].test(key(move));
+        }
+
+    private:
+        static int key(const Move& move)
+        {
+            return move.from[0] * 64 + move.to[0];
+        }
+
+        std::bitset<64 * 64> played[2];
+    };
+
+    // Filled during an iteration of the thread. Playouts running on helper threads aren't recorded.
+    thread_local AmafMoves amafMoves;
+}
 
 void MonteCarloNode::runIteration(const Board &board, unsigned int maxMoveCount)
 {
+    MonteCarloSettings settings;
+    settings.maxMoveCount = maxMoveCount;
+    runIteration(board, settings);
+}
+
+void MonteCarloNode::runIteration(const Board& board, const MonteCarloSettings& settings)
+{
+    Board iterationBoard = board;
+    runIterationOnBoard(iterationBoard, settings, 0u);
+}
+
+void MonteCarloNode::runIteration(const Board& board, const MonteCarloSettings& settings, int rootChildIdx)
+{
+    assert(rootChildIdx < (int)childNodes.size() && "The root must be expanded to choose its move.");
     Board iterationBoard = board;
-    runIterationOnBoard(iterationBoard, maxMoveCount, true);
+    runIterationOnBoard(iterationBoard, settings, 0u, rootChildIdx);
 }
 
-float MonteCarloNode::runIterationOnBoard(Board& board, unsigned int maxMoveCount, bool isRoot)
+float MonteCarloNode::runIterationOnBoard(Board& board, const MonteCarloSettings& settings, unsigned int depth, int forcedChildIdx)
 {
-    nodeIterations++;
+    const bool isRoot = depth == 0u;
+    const bool firstVisit = nodeIterations == 0u;
+    if (isRoot && settings.raveEquivalence > 0.0f)
+        amafMoves.clear();
+    // Every iteration weighs as much as the playouts run at its leaf.
+    const unsigned int iterationWeight = settings.leafPlayouts;
+    nodeIterations += iterationWeight;
     float playoutResult;
-    if (conclusiveResult)
+    if (result != ProvenResult::UNKNOWN)
     {
-        playoutResult = points / nodeIterations;
+        playoutResult = provenPoints(result);
     }
-    else if (nodeIterations == 1u && !isRoot)
+    else if (firstVisit && !isRoot)
     {
-        playoutResult = randomPlayout(board, maxMoveCount);
+        playoutResult = runLeafPlayouts(board, settings);
+        minimaxValue = playoutResult;
+    }
+    else if (childNodes.size() == 0u && !isRoot && settings.memoryBudget && settings.memoryBudget->isFull())
+    {
+        // No room to expand, keep treating this node as a leaf.
+        playoutResult = runLeafPlayouts(board, settings);
+        minimaxValue = playoutResult;
     }
     else
     {
         if (childNodes.size() == 0u)
-            expand(board);
-        playoutResult = runOnBestChild(board, maxMoveCount);
+            expand(board, settings, depth);
+        else if (possibleMoves.size() == 0u && depth <= settings.keepMovesDepth)
+            possibleMoves = orderedMoves(board, settings); // A compact node has moved up close to the root.
+        playoutResult = forcedChildIdx >= 0 ? runOnChild(board, settings, depth, forcedChildIdx) : runOnBestChild(board, settings, depth);
     }
-    points += playoutResult;
+    points += playoutResult * iterationWeight;
+    if (result != ProvenResult::UNKNOWN)
+        minimaxValue = provenPoints(result);
     return playoutResult;
 }
 
-float MonteCarloNode::runOnBestChild(Board& board, unsigned int maxMoveCount)
+float MonteCarloNode::runOnBestChild(Board& board, const MonteCarloSettings& settings, unsigned int depth)
 {
-    Move bestMove;
-    MonteCarloNode* bestChild = highestUCB1Child(&bestMove);
-    board.applyMove(bestMove);
-    float childResult = bestChild->runIterationOnBoard(board, maxMoveCount);
+    return runOnChild(board, settings, depth, selectChildIndex(widenedChildCount(settings), settings));
+}
+
+float MonteCarloNode::runOnChild(Board& board, const MonteCarloSettings& settings, unsigned int depth, int childIdx)
+{
+    // A compact node only knows the index of the child, the moves are generated again in the same order.
+    const Color player = board.getCurrentPlayer();
+    const Move move = possibleMoves.size() > 0u ? possibleMoves[childIdx] : orderedMoves(board, settings)[childIdx];
+    board.applyMove(move);
+    std::shared_ptr<MonteCarloNode>& child = childNodes[childIdx];
+    float childResult;
+    if (settings.transpositions && board.isRepetition())
+    {
+        // In a graph the shared child can be a node this iteration already entered through a cycle.
+        // The repetition is a draw only on this path, so the draw is backed up on this edge and the child isn't entered,
+        // which also keeps a proven result of the child from being taken for the repetition.
+        childResult = 0.5f;
+    }
+    else if (!child && settings.memoryBudget && settings.memoryBudget->isFull())
+    {
+        // The playout still counts in this node's statistics, but the child node isn't kept.
+        MonteCarloNode detachedChild;
+        childResult = detachedChild.runIterationOnBoard(board, settings, depth + 1u);
+        if (detachedChild.result != ProvenResult::UNKNOWN)
+            updateProvenResult(childIdx, detachedChild.result);
+        if (childEvaluations.size() > 0u)
+            childEvaluations[childIdx] = detachedChild.minimaxValue;
+    }
+    else
+    {
+        if (!child)
+        {
+            child = createChild(board, settings);
+            if (settings.memoryBudget)
+                settings.memoryBudget->add(1u, nodeBytes());
+        }
+        childResult = child->runIterationOnBoard(board, settings, depth + 1u);
+        if (child->result != ProvenResult::UNKNOWN)
+            updateProvenResult(childIdx, child->result);
+        if (childEvaluations.size() > 0u)
+            childEvaluations[childIdx] = child->minimaxValue;
+    }
+    childVisits[childIdx] += settings.leafPlayouts;
+    childPoints[childIdx] += childResult * settings.leafPlayouts;
+    if (childEvaluations.size() > 0u)
+        updateMinimaxValue();
+    if (settings.raveEquivalence > 0.0f)
+    {
+        amafMoves.record(player, move);
+        if (raveVisits.size() > 0u)
+            updateRaveStatistics(player, childResult, settings.leafPlayouts);
+    }
     return 1.0f - childResult;
 }
 
+void MonteCarloNode::updateRaveStatistics(Color player, float childResult, unsigned int weight)
+{
+    // Every move the player made later in the iteration counts as if it had been played here.
+    for (size_t i = 0u; i < possibleMoves.size(); i++)
+    {
+        if (!amafMoves.contains(player, possibleMoves[i]))
+            continue;
+        if (raveVisits[i] > UINT16_MAX - weight)
+        {
+            // The counters are small, keep the average but forget half of the history.
+            raveVisits[i] /= 2u;
+            ravePoints[i] /= 2.0f;
+        }
+        raveVisits[i] += weight;
+        ravePoints[i] += childResult * weight;
+    }
+}
+
+void MonteCarloNode::updateMinimaxValue()
+{
+    // The opponent's value of a child is the value of the move for the player in turn.
+    float bestValue = -1.0f;
+    for (float childEvaluation : childEvaluations)
+    {
+        if (childEvaluation != UNEVALUATED)
+            bestValue = std::max(bestValue, 1.0f - childEvaluation);
+    }
+    if (bestValue != -1.0f)
+        minimaxValue = bestValue;
+}
+
+void MonteCarloNode::updateProvenResult(int childIdx, ProvenResult childResult)
+{
+    if (childResults[childIdx] != ProvenResult::UNKNOWN)
+        return;
+    childResults[childIdx] = childResult;
+    provenChildren++;
+
+    // A move into a lost position for the opponent wins. Otherwise the result is only known
+    // when every move has been proven, then the best of them is taken.
+    if (childResult == ProvenResult::LOSS)
+    {
+        result = ProvenResult::WIN;
+    }
+    else if (provenChildren == childResults.size())
+    {
+        const ProvenResult worstForOpponent = *std::min_element(childResults.begin(), childResults.end());
+        result = worstForOpponent == ProvenResult::WIN ? ProvenResult::LOSS : ProvenResult::DRAW;
+    }
+}
+
+float MonteCarloNode::provenPoints(ProvenResult result)
+{
+    switch (result)
+    {
+        case ProvenResult::WIN: return 1.0f;
+        case ProvenResult::LOSS: return 0.0f;
+        default: return 0.5f;
+    }
+}
+
+ProvenResult MonteCarloNode::provenResult() const
+{
+    return result;
+}
+
+std::shared_ptr<MonteCarloNode> MonteCarloNode::createChild(const Board& board, const MonteCarloSettings& settings)
+{
+    if (!settings.transpositions)
+        return std::make_shared<MonteCarloNode>();
+    return settings.transpositions->findOrCreate(board.getHash());
+}
+
 float MonteCarloNode::UCB1(unsigned int totalVisits, bool inversePoints)
 {
     if (!nodeIterations)
@@ -59,34 +280,116 @@ float MonteCarloNode::UCB1(unsigned int totalVisits, bool inversePoints)
     {
         exploitationFactor = 1.0f - exploitationFactor;
     }
-    float explorationFactor = 2 * float(std::sqrt(std::log(totalVisits) / nodeIterations));
-    return exploitationFactor + explorationFactor;
+    return exploitationFactor + UCBKernel::exploration(nodeIterations, UCBKernel::explorationScale(totalVisits));
 }
 
 MonteCarloNode *MonteCarloNode::highestUCB1Child(Move *populateMove)
 {
-    if (childNodes.size() == 0u)
+    if (possibleMoves.size() == 0u)
         return nullptr;
 
-    float bestChildUCB1 = -1.0f;
-    std::vector<int> bestChildIndices;
-    for (int i = 0; i < childNodes.size(); i++)
+    const int bestChildIdx = selectChildIndex((int)childNodes.size(), MonteCarloSettings());
+    *populateMove = possibleMoves[bestChildIdx];
+    return childNodes[bestChildIdx].get();
+}
+
+int MonteCarloNode::widenedChildCount(const MonteCarloSettings& settings) const
+{
+    const int childCount = (int)childNodes.size();
+    if (settings.wideningConstant <= 0.0f)
+        return childCount;
+
+    const float widenedCount = settings.wideningConstant * std::pow(float(nodeIterations), settings.wideningExponent);
+    if (widenedCount >= childCount)
+        return childCount;
+    return std::max(1, (int)widenedCount);
+}
+
+int MonteCarloNode::selectChildIndex(int childCount, const MonteCarloSettings& settings)
+{
+    const float minimaxWeight = settings.minimaxWeight;
+    assert(childCount <= UCBKernel::MAX_CHILDREN);
+    const float* selectionPoints = childPoints.data();
+    float blendedPoints[UCBKernel::MAX_CHILDREN];
+    if (raveVisits.size() > 0u)
     {
-        float thisChildUCB1 = childNodes[i].UCB1(nodeIterations, true);
-        if (thisChildUCB1 > bestChildUCB1)
+        // RAVE: beta = sqrt(k / (3n + k)) of the average comes from the all-moves-as-first statistics,
+        // which dominate while the child has few visits of its own.
+        for (int i = 0; i < childCount; i++)
         {
-            bestChildIndices.clear();
-            bestChildIndices.push_back(i);   
-            bestChildUCB1 = thisChildUCB1;
+            blendedPoints[i] = childPoints[i];
+            if (raveVisits[i] == 0u || childVisits[i] == 0u)
+                continue;
+            const float beta = std::sqrt(settings.raveEquivalence / (3.0f * childVisits[i] + settings.raveEquivalence));
+            blendedPoints[i] = (1.0f - beta) * childPoints[i] + beta * ravePoints[i] / raveVisits[i] * childVisits[i];
         }
-        else if (thisChildUCB1 == bestChildUCB1)
+        selectionPoints = blendedPoints;
+    }
+    if (minimaxWeight > 0.0f && childEvaluations.size() > 0u)
+    {
+        // Mixing the points with the minimax value times the visits mixes the averages the kernel computes from them.
+        for (int i = 0; i < childCount; i++)
         {
-            bestChildIndices.push_back(i);
+            blendedPoints[i] = childEvaluations[i] == UNEVALUATED ? selectionPoints[i] :
+                (1.0f - minimaxWeight) * selectionPoints[i] + minimaxWeight * childEvaluations[i] * childVisits[i];
         }
+        selectionPoints = blendedPoints;
     }
-    const int bestChildIdx = bestChildIndices[Random::Range(0, (int)bestChildIndices.size() - 1)];
-    *populateMove = possibleMoves[bestChildIdx];
-    return &childNodes[bestChildIdx];
+    float childScores[UCBKernel::MAX_CHILDREN];
+    float bestChildUCB1;
+    if (childPriors.size() > 0u)
+    {
+        // Unvisited children are assumed to be as good as this node has been on average.
+        bestChildUCB1 = UCBKernel::scorePUCTChildren(
+            childVisits.data(), selectionPoints, childPriors.data(), childCount,
+            settings.puctConstant * std::sqrt(float(nodeIterations)), points / nodeIterations, childScores
+        );
+    }
+    else
+    {
+        bestChildUCB1 = UCBKernel::scoreChildren(
+            childVisits.data(), selectionPoints, childCount, UCBKernel::explorationScale(nodeIterations), childScores
+        );
+    }
+    if (raveVisits.size() > 0u && bestChildUCB1 == FLT_MAX)
+    {
+        // Every child is tried once, the unvisited ones in the order of their RAVE values.
+        bestChildUCB1 = -FLT_MAX;
+        for (int i = 0; i < childCount; i++)
+        {
+            if (childVisits[i] > 0u)
+                childScores[i] = -FLT_MAX;
+            else
+                childScores[i] = raveVisits[i] > 0u ? 1.0f - ravePoints[i] / raveVisits[i] : 0.5f;
+            bestChildUCB1 = std::max(bestChildUCB1, childScores[i]);
+        }
+    }
+    if (provenChildren > 0u)
+    {
+        // More iterations on a proven child cannot change its value.
+        bestChildUCB1 = -FLT_MAX;
+        for (int i = 0; i < childCount; i++)
+        {
+            if (childResults[i] != ProvenResult::UNKNOWN)
+                childScores[i] = -FLT_MAX;
+            else
+                bestChildUCB1 = std::max(bestChildUCB1, childScores[i]);
+        }
+        // Widening may have let in only proven children, the node itself isn't proven yet.
+        if (bestChildUCB1 == -FLT_MAX && size_t(childCount) < childNodes.size())
+            return selectChildIndex((int)childNodes.size(), settings);
+    }
+
+    int bestChildIdx = 0;
+    unsigned int tiedChildren = 0u;
+    for (int i = 0; i < childCount; i++)
+    {
+        // Reservoir sampling: the n:th tied child replaces the pick with probability 1/n,
+        // which gives every tied child the same chance without collecting them anywhere.
+        if (childScores[i] == bestChildUCB1 && Random::Range(0u, tiedChildren++) == 0u)
+            bestChildIdx = i;
+    }
+    return bestChildIdx;
 }
 
 unsigned int MonteCarloNode::nodeVisits() const
@@ -94,16 +397,24 @@ unsigned int MonteCarloNode::nodeVisits() const
     return nodeIterations;
 }
 
-Move MonteCarloNode::highestWinrateMove() const
+Move MonteCarloNode::highestWinrateMove(float minimaxWeight) const
 {
     float bestWinRate = -1.0f;
     Move bestMove;
-    for (int i = 0; i < childNodes.size(); i++)
+    for (size_t i = 0u; i < possibleMoves.size(); i++)
     {
-        if (childNodes[i].nodeIterations == 0u)
+        if (childResults[i] == ProvenResult::LOSS)
+            return possibleMoves[i];
+        if (childVisits[i] == 0u)
             continue;
 
-        float childWinrate = 1.0f - (childNodes[i].points / childNodes[i].nodeIterations);
+        float childWinrate = 1.0f - (childPoints[i] / childVisits[i]);
+        if (minimaxWeight > 0.0f && childEvaluations.size() > 0u && childEvaluations[i] != UNEVALUATED)
+            childWinrate = (1.0f - minimaxWeight) * childWinrate + minimaxWeight * (1.0f - childEvaluations[i]);
+        if (childResults[i] == ProvenResult::DRAW)
+            childWinrate = 0.5f;
+        else if (childResults[i] == ProvenResult::WIN)
+            childWinrate = -0.5f; // Only played if every move loses.
         if (childWinrate > bestWinRate)
         {
             bestWinRate = childWinrate;
@@ -114,19 +425,31 @@ Move MonteCarloNode::highestWinrateMove() const
     return bestMove;
 }
 
-MonteCarloNode MonteCarloNode::getNodeForMove(const Move &move)
+Move MonteCarloNode::mostVisitedMove() const
 {
-    // If this node has not been expanded yet, just return a new node.
-    if (childNodes.size() == 0u)
+    int bestIdx = -1;
+    for (size_t i = 0u; i < possibleMoves.size(); i++)
     {
-        return MonteCarloNode();
+        if (childResults[i] == ProvenResult::LOSS)
+            return possibleMoves[i];
+        // Unproven moves come before proven draws and those before proven losses, ties go to the most visits.
+        if (bestIdx == -1 || childResults[i] < childResults[bestIdx] ||
+            (childResults[i] == childResults[bestIdx] && childVisits[i] > childVisits[bestIdx]))
+        {
+            bestIdx = int(i);
+        }
     }
+    assert(bestIdx != -1 && "Shouldn't call this function before the node has been expanded.");
+    return possibleMoves[bestIdx];
+}
 
-    for (int i = 0; i < childNodes.size(); i++)
+MonteCarloNode MonteCarloNode::getNodeForMove(const Move &move)
+{
+    for (size_t i = 0u; i < possibleMoves.size(); i++)
     {
-        if (possibleMoves[i] == move)
+        if (possibleMoves[i] == move && childNodes[i])
         {
-            return childNodes[i];
+            return *childNodes[i];
         }
     }
 
@@ -134,26 +457,204 @@ MonteCarloNode MonteCarloNode::getNodeForMove(const Move &move)
     return MonteCarloNode();
 }
 
-void MonteCarloNode::expand(const Board& board)
+std::vector<MoveStatistics> MonteCarloNode::getMoveStatistics() const
+{
+    std::vector<MoveStatistics> moveStats(possibleMoves.size());
+    for (size_t i = 0u; i < possibleMoves.size(); i++)
+    {
+        moveStats[i].move = possibleMoves[i];
+        moveStats[i].visits = childVisits[i];
+        // The parent stores the points of the player in turn after the move.
+        moveStats[i].points = childVisits[i] - childPoints[i];
+        // A position lost for the player in turn after the move is won by the move.
+        if (childResults[i] == ProvenResult::LOSS)
+            moveStats[i].result = ProvenResult::WIN;
+        else if (childResults[i] == ProvenResult::WIN)
+            moveStats[i].result = ProvenResult::LOSS;
+        else
+            moveStats[i].result = childResults[i];
+    }
+    return moveStats;
+}
+
+void MonteCarloNode::setMoveStatistics(const std::vector<MoveStatistics>& moveStats)
+{
+    unsigned int totalVisits = 0u;
+    for (size_t i = 0u; i < possibleMoves.size(); i++)
+    {
+        for (const MoveStatistics& stats : moveStats)
+        {
+            if (possibleMoves[i] == stats.move)
+            {
+                childVisits[i] = stats.visits;
+                childPoints[i] = stats.visits - stats.points;
+                break;
+            }
+        }
+        totalVisits += childVisits[i];
+    }
+    nodeIterations = std::max(nodeIterations, totalVisits);
+}
+
+std::vector<Move> MonteCarloNode::orderedMoves(const Board& board, const MonteCarloSettings& settings)
+{
+    std::vector<Move> moves = board.findPossibleMoves();
+    if (settings.wideningConstant > 0.0f)
+    {
+        // Widening considers the moves in order, so the likely good ones should come first.
+        std::vector<std::pair<int, Move>> scoredMoves;
+        scoredMoves.reserve(moves.size());
+        for (const Move& move : moves)
+        {
+            scoredMoves.emplace_back(captureScore(board, move), move);
+        }
+        std::stable_sort(scoredMoves.begin(), scoredMoves.end(), [](const auto& a, const auto& b) {
+            return a.first > b.first;
+        });
+        for (size_t i = 0u; i < scoredMoves.size(); i++)
+        {
+            moves[i] = scoredMoves[i].second;
+        }
+    }
+    return moves;
+}
+
+void MonteCarloNode::expand(const Board& board, const MonteCarloSettings& settings, unsigned int depth)
+{
+    std::vector<Move> moves = orderedMoves(board, settings);
+    // Child nodes are created on their first visit, most children of deep nodes never get one.
+    childNodes.resize(moves.size());
+    childVisits.assign(moves.size(), 0u);
+    childPoints.assign(moves.size(), 0.0f);
+    childResults.assign(moves.size(), ProvenResult::UNKNOWN);
+    if (settings.minimaxWeight > 0.0f)
+        childEvaluations.assign(moves.size(), UNEVALUATED);
+    if (settings.movePrior)
+        settings.movePrior->computePriors(board, moves, childPriors);
+    // Compact nodes don't know their moves, so they can't match them with the moves of the iterations.
+    if (settings.raveEquivalence > 0.0f && depth <= settings.keepMovesDepth)
+    {
+        raveVisits.assign(moves.size(), 0u);
+        ravePoints.assign(moves.size(), 0.0f);
+    }
+    if (depth <= settings.keepMovesDepth)
+        possibleMoves = std::move(moves);
+    if (settings.memoryBudget)
+        settings.memoryBudget->add(0u, expansionBytes());
+}
+
+size_t MonteCarloNode::nodeBytes()
+{
+    // The node and the control block allocated with it by make_shared.
+    return sizeof(MonteCarloNode) + 2u * sizeof(void*);
+}
+
+size_t MonteCarloNode::expansionBytes() const
+{
+    const size_t childBytes = sizeof(std::shared_ptr<MonteCarloNode>) + sizeof(unsigned int) + sizeof(float) + sizeof(ProvenResult);
+    return childNodes.size() * childBytes + possibleMoves.size() * sizeof(Move) +
+        (childEvaluations.size() + childPriors.size()) * sizeof(float) + raveVisits.size() * sizeof(uint16_t) + ravePoints.size() * sizeof(float);
+}
+
+void MonteCarloNode::measureTree(size_t& nodeCount, size_t& byteCount) const
+{
+    nodeCount = 0u;
+    byteCount = 0u;
+    // With transpositions the tree is a graph, every node is counted only once.
+    std::unordered_set<const MonteCarloNode*> counted = { this };
+    std::vector<const MonteCarloNode*> openNodes = { this };
+    while (openNodes.size() > 0)
+    {
+        const MonteCarloNode* node = openNodes.back();
+        openNodes.pop_back();
+        nodeCount++;
+        byteCount += nodeBytes() + node->expansionBytes();
+        for (const std::shared_ptr<MonteCarloNode>& child : node->childNodes)
+        {
+            if (child && counted.insert(child.get()).second)
+                openNodes.push_back(child.get());
+        }
+    }
+}
+
+void MonteCarloNode::pruneSubtrees(unsigned int maxVisits)
 {
-    possibleMoves = board.findPossibleMoves();
-    childNodes.resize(possibleMoves.size());
+    std::unordered_set<MonteCarloNode*> visited = { this };
+    std::vector<MonteCarloNode*> openNodes = { this };
+    while (openNodes.size() > 0)
+    {
+        MonteCarloNode* node = openNodes.back();
+        openNodes.pop_back();
+        for (size_t i = 0u; i < node->childNodes.size(); i++)
+        {
+            std::shared_ptr<MonteCarloNode>& child = node->childNodes[i];
+            if (!child)
+                continue;
+            if (node != this && node->childVisits[i] <= maxVisits)
+                child.reset();
+            else if (visited.insert(child.get()).second)
+                openNodes.push_back(child.get());
+        }
+    }
 }
 
-float MonteCarloNode::randomPlayout(Board &board, unsigned int maxMoveCount)
+float MonteCarloNode::runLeafPlayouts(Board& board, const MonteCarloSettings& settings)
 {
-    std::vector<Move> nextMoves = board.findPossibleMoves();
-    if (nextMoves.size() == 0)
+    Move anyMove;
+    if (!board.findRandomMove(anyMove))
     {
-        conclusiveResult = true;
-        return board.isCheck() ? 0.0f : 0.5f;
+        result = board.isCheck() ? ProvenResult::LOSS : ProvenResult::DRAW;
+        return provenPoints(result);
     }
 
-    unsigned int movesLeft = maxMoveCount;
+    if (settings.evaluateLeaves)
+    {
+        const unsigned int depth = settings.resolveCapturesDepth;
+        return evaluationPoints(depth > 0u ? BoardEvaluator::evaluateQuiescent(board, depth) : BoardEvaluator::evaluateBoard(board), board.getCurrentPlayer());
+    }
+
+    // The extra playouts start from their own copies of the leaf, the last one can use the board itself.
+    unsigned int extraPlayouts = settings.leafPlayouts - 1u;
+    float totalResult = 0.0f;
+    unsigned int workerPlayouts = 0u;
+    if (settings.parallelLeafPlayouts && settings.playoutWorkers)
+    {
+        workerPlayouts = std::min(extraPlayouts, settings.playoutWorkers->workerCount());
+        if (workerPlayouts > 0u)
+            settings.playoutWorkers->start(board, workerPlayouts, &MonteCarloNode::randomPlayout, settings);
+        extraPlayouts -= workerPlayouts;
+    }
+    for (unsigned int i = 0u; i < extraPlayouts; i++)
+    {
+        Board playoutBoard = board;
+        totalResult += randomPlayout(playoutBoard, settings);
+    }
+    totalResult += randomPlayout(board, settings);
+    if (workerPlayouts > 0u)
+        totalResult += settings.playoutWorkers->wait();
+    return totalResult / settings.leafPlayouts;
+}
+
+float MonteCarloNode::randomPlayout(Board &board, const MonteCarloSettings& settings)
+{
+    const PlayoutPolicy& policy = settings.playoutPolicy ? *settings.playoutPolicy : PlayoutPolicy::uniform();
+    unsigned int movesLeft = settings.maxMoveCount;
+    unsigned int extensionMovesLeft = settings.quietExtension;
+    // The material is only followed when it can end the playout, and then updated move by move.
+    const bool trackMaterial = settings.decisiveMaterial > 0.0f;
+    float materialBalance = trackMaterial ? BoardEvaluator::evaluateBoard(board) : 0.0f;
+    bool lastMoveQuiet = true;
     Color nodeColor = board.getCurrentPlayer();
-    while (movesLeft-- > 0u)
+    Move nextMove;
+    while (true)
     {
-        if (nextMoves.size() == 0)
+        if (movesLeft > 0u)
+            movesLeft--;
+        else if (!lastMoveQuiet && extensionMovesLeft > 0u)
+            extensionMovesLeft--;
+        else
+            break;
+        if (!policy.selectMove(board, nextMove))
         {
             if (board.isCheck())
             {
@@ -165,15 +666,33 @@ float MonteCarloNode::randomPlayout(Board &board, unsigned int maxMoveCount)
         {
             return 0.5f;
         }
-        int moveIdx = Random::Range(0, (int)nextMoves.size() - 1);
-        board.applyMove(nextMoves[moveIdx]);
-        nextMoves = board.findPossibleMoves();
+        const Piece captured = board.capturedPiece(nextMove);
+        if (settings.raveEquivalence > 0.0f)
+            amafMoves.record(board.getCurrentPlayer(), nextMove);
+        if (trackMaterial)
+        {
+            float materialGain = BoardEvaluator::pieceValue(captured);
+            if (nextMove.isPromotion())
+                materialGain += BoardEvaluator::pieceValue(nextMove.promotion) - BoardEvaluator::pieceValue(Piece::PAWN);
+            materialBalance += board.getCurrentPlayer() == Color::WHITE ? materialGain : -materialGain;
+        }
+        board.applyMove(nextMove);
+        if (trackMaterial && std::abs(materialBalance) >= settings.decisiveMaterial)
+            break;
+        // Quietness only matters once the regular moves have run out.
+        if (movesLeft == 0u && extensionMovesLeft > 0u)
+            lastMoveQuiet = captured == Piece::NONE && !nextMove.isPromotion() && !board.isCheck();
     }
     
-    float boardEval = BoardEvaluator::evaluateBoard(board);
-    float whiteWinProb = (boardEval / (1 + std::abs(boardEval))) * 0.2f + 0.5f;
-    float winProb = nodeColor == Color::WHITE ? whiteWinProb : 1.0f - whiteWinProb;
-    return winProb;
+    float boardEval = settings.resolveCapturesDepth > 0u ? BoardEvaluator::evaluateQuiescent(board, settings.resolveCapturesDepth) :
+        trackMaterial ? materialBalance : BoardEvaluator::evaluateBoard(board);
+    return evaluationPoints(boardEval, nodeColor);
+}
+
+float MonteCarloNode::evaluationPoints(float whiteEvaluation, Color player)
+{
+    float whiteWinProb = (whiteEvaluation / (1 + std::abs(whiteEvaluation))) * 0.2f + 0.5f;
+    return player == Color::WHITE ? whiteWinProb : 1.0f - whiteWinProb;
 }
 
 void MonteCarloNode::printStats() const
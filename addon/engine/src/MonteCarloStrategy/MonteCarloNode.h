@@ -1,35 +1,123 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "../GameState.h"
 #include "../Move.h"
+#include "MonteCarloSettings.h"
 
 class Board;
 
+// Game theoretical result of a position for the player in turn, once the search has proven it.
+// Ordered from the worst to the best result.
+enum class ProvenResult : uint8_t
+{
+    UNKNOWN, LOSS, DRAW, WIN
+};
+
+// Statistics of a single move from the point of view of the player making it.
+struct MoveStatistics
+{
+    Move move;
+    unsigned int visits = 0u;
+    float points = 0.0f;
+    // What the move is proven to bring the player making it.
+    ProvenResult result = ProvenResult::UNKNOWN;
+};
+
 class MonteCarloNode
 {
 public:
     // Simulates the given board until the game ends or max number of moves are reached.
     void runIteration(const Board& board, unsigned int maxMoveCount = 15u);
+    void runIteration(const Board& board, const MonteCarloSettings& settings);
+    // Runs the iteration through the given move of this root instead of the selected one. The root must be expanded.
+    void runIteration(const Board& board, const MonteCarloSettings& settings, int rootChildIdx);
     void prepareRootNode(const Board& board);
     float UCB1(unsigned int totalVisits, bool inversePoints = false);
+    // Returns nullptr if the node hasn't been expanded or the best child hasn't been visited yet.
     MonteCarloNode* highestUCB1Child(Move* populateMove);
     unsigned int nodeVisits() const;
-    Move highestWinrateMove() const;
+    // Plays a proven win right away and avoids proven losses. The minimax weight mixes in the minimax values as in the selection.
+    Move highestWinrateMove(float minimaxWeight = 0.0f) const;
+    // Same, but picks the unproven move with the most visits instead of the best average.
+    Move mostVisitedMove() const;
+    ProvenResult provenResult() const;
+    // The moves of a compact node are only known after it has been iterated as a root.
     MonteCarloNode getNodeForMove(const Move& move);
+    std::vector<MoveStatistics> getMoveStatistics() const;
+    // Overwrites the statistics of the children, e.g. with statistics merged from other trees.
+    void setMoveStatistics(const std::vector<MoveStatistics>& moveStats);
     void printStats() const;
+    // Counts the nodes reachable from this node and estimates the memory they use.
+    void measureTree(size_t& nodeCount, size_t& byteCount) const;
+    // Releases the subtrees below this node whose moves have been visited at most maxVisits times.
+    // The statistics of the moves stay in the parents, only the nodes are lost. Children of this node are kept.
+    void pruneSubtrees(unsigned int maxVisits);
 
 private:
     // Actual implementation is this method. The public version takes a const reference to the board for safety reasons.
-    float runIterationOnBoard(Board& board, unsigned int maxMoveCount, bool isRoot = false);
-    float runOnBestChild(Board& board, unsigned int maxMoveCount);
-    void expand(const Board& board);
-    float randomPlayout(Board& board, unsigned int maxMoveCount);
+    float runIterationOnBoard(Board& board, const MonteCarloSettings& settings, unsigned int depth, int forcedChildIdx = -1);
+    float runOnBestChild(Board& board, const MonteCarloSettings& settings, unsigned int depth);
+    float runOnChild(Board& board, const MonteCarloSettings& settings, unsigned int depth, int childIdx);
+    // Only the first childCount children take part in the selection. Proven children are skipped.
+    // A positive minimax weight mixes the minimax values of the children into their averages.
+    // Children with priors are scored with PUCT, the others with UCB1.
+    int selectChildIndex(int childCount, const MonteCarloSettings& settings);
+    int widenedChildCount(const MonteCarloSettings& settings) const;
+    // Records a child proven by the last iteration and checks whether that proves this node too.
+    void updateProvenResult(int childIdx, ProvenResult childResult);
+    static float provenPoints(ProvenResult result);
+    // Adds the result to the RAVE statistics of the children whose moves the player made later in the iteration.
+    void updateRaveStatistics(Color player, float childResult, unsigned int weight);
+    // Implicit minimax: the value of the best evaluated child becomes the value of this node.
+    void updateMinimaxValue();
+    // Children are only created, or looked up from the transposition table, when they are first visited.
+    std::shared_ptr<MonteCarloNode> createChild(const Board& board, const MonteCarloSettings& settings);
+    void expand(const Board& board, const MonteCarloSettings& settings, unsigned int depth);
+    // Legal moves in the order of the children. The order is the same every time for the same position.
+    static std::vector<Move> orderedMoves(const Board& board, const MonteCarloSettings& settings);
+    // Runs the playouts of a new leaf and returns their average result.
+    float runLeafPlayouts(Board& board, const MonteCarloSettings& settings);
+    static size_t nodeBytes();
+    // Memory used by the arrays of the children and the stored moves.
+    size_t expansionBytes() const;
+    static float randomPlayout(Board& board, const MonteCarloSettings& settings);
+    // Maps an evaluation in pawns to expected points for the given player.
+    static float evaluationPoints(float whiteEvaluation, Color player);
+
+    static constexpr float UNEVALUATED = -1.0f;
 
+    // Moves to the children. Compact nodes deep in the tree leave this empty and identify
+    // their children only by the index in the arrays below.
     std::vector<Move> possibleMoves;
-    std::vector<MonteCarloNode> childNodes;
+    // Children may be shared with other parents when a transposition table is in use.
+    std::vector<std::shared_ptr<MonteCarloNode>> childNodes;
+    // Statistics of the moves to the children, kept in the parent in plain arrays so the selection
+    // can scan them without touching the children. Points are from the child's point of view.
+    // With transpositions these are per edge, while a shared child counts the visits of all its parents.
+    std::vector<unsigned int> childVisits;
+    std::vector<float> childPoints;
+    // Proven results of the children from their own point of view. Kept in the parent as well,
+    // so that they survive when the child nodes are pruned.
+    std::vector<ProvenResult> childResults;
+    unsigned int provenChildren = 0u;
+    // Minimax values of the children from their own point of view, UNEVALUATED until visited.
+    // Only kept when the settings mix minimax values into the selection.
+    std::vector<float> childEvaluations;
+    // Prior probabilities of the moves for the PUCT selection, only kept when the settings have a move prior.
+    std::vector<float> childPriors;
+    // All-moves-as-first statistics of the children from their own point of view, only kept with RAVE enabled.
+    // The visit counters are 16 bits to keep the nodes small, they are halved before they overflow.
+    std::vector<uint16_t> raveVisits;
+    std::vector<float> ravePoints;
     float points = 0.0f;
+    // Heuristic value of this node for the player in turn, backed up as in minimax.
+    float minimaxValue = 0.5f;
     unsigned int nodeIterations = 0u;
-    bool conclusiveResult = false;
+    ProvenResult result = ProvenResult::UNKNOWN;
+
+    friend class MonteCarloTranspositionTable;
 };
\ No newline at end of file
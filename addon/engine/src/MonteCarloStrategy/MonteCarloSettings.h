@@ -0,0 +1,63 @@
+#pragma once
+
+#include <climits>
+
+class LeafPlayoutWorkers;
+class MonteCarloMemoryBudget;
+class MonteCarloTranspositionTable;
+class MovePrior;
+class PlayoutPolicy;
+
+// Tunable parameters of the Monte Carlo tree search. The defaults match the plain UCT search.
+struct MonteCarloSettings
+{
+    // Simulated moves before a playout is cut off and the position is evaluated.
+    unsigned int maxMoveCount = 15u;
+    // Adaptive cutoff: a playout ends early once one side is ahead by at least this much material, in pawns.
+    // Zero disables the early cutoff.
+    float decisiveMaterial = 0.0f;
+    // Extra moves a playout may make past maxMoveCount while the last move was a capture, a promotion or a check,
+    // so that it doesn't end in the middle of an exchange.
+    unsigned int quietExtension = 0u;
+    // Depth of the capture-only search that evaluates the position a playout ends in. Zero counts the material as it is.
+    unsigned int resolveCapturesDepth = 0u;
+    // Playouts run from every new leaf. Their average is backed up with the weight of all of them,
+    // so the selection pass is shared by the whole batch.
+    unsigned int leafPlayouts = 1u;
+    // Runs the batched leaf playouts on their own threads instead of one after another.
+    // The strategy starts the threads once and hands them over in playoutWorkers.
+    bool parallelLeafPlayouts = false;
+    // Without workers the batched playouts run one after another.
+    LeafPlayoutWorkers* playoutWorkers = nullptr;
+    // Progressive widening: a node visited n times only considers its first
+    // max(1, wideningConstant * n^wideningExponent) moves, ordered by a cheap capture score.
+    // Zero disables widening and all moves are considered from the start.
+    float wideningConstant = 0.0f;
+    float wideningExponent = 0.5f;
+    // Compact nodes: nodes deeper than this don't keep a list of their moves. It is generated again from
+    // the position whenever the node is entered, trading a little time for a smaller tree.
+    unsigned int keepMovesDepth = UINT_MAX;
+    // When set, positions reached through different move orders share a single node.
+    MonteCarloTranspositionTable* transpositions = nullptr;
+    // When set, the tree stops growing once the budget is full. Iterations reaching
+    // the edge of the tree then end in a playout without adding nodes.
+    MonteCarloMemoryBudget* memoryBudget = nullptr;
+    // Scores new leaves with the static evaluation, resolved by resolveCapturesDepth captures, instead of playouts.
+    bool evaluateLeaves = false;
+    // Implicit minimax: selection mixes the average of a child with its minimax value backed up
+    // from the leaf values, (1 - weight) * average + weight * minimax. Zero uses only the averages.
+    float minimaxWeight = 0.0f;
+    // PUCT selection: the children get prior probabilities from this model when their parent is expanded and
+    // are scored by average + puctConstant * prior * sqrt(parent visits) / (1 + visits). Null uses UCB1.
+    const MovePrior* movePrior = nullptr;
+    float puctConstant = 1.0f;
+    // Root selection by sequential halving while the strategy is thinking on its own time. The iterations the
+    // time management allows for the move are split into rounds, each dropping the worse half of the moves.
+    bool sequentialHalving = false;
+    // RAVE: every move made later in an iteration also updates the all-moves-as-first statistics of the same
+    // move higher up in the tree. They are mixed into the selection with weight sqrt(k / (3n + k)), where k is
+    // this equivalence parameter and n the visits of the child. Zero disables RAVE.
+    float raveEquivalence = 0.0f;
+    // Chooses the moves of the playouts. Null plays uniformly random moves.
+    const PlayoutPolicy* playoutPolicy = nullptr;
+};
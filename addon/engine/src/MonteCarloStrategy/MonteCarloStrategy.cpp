@@ -1,25 +1,134 @@
 #include "MonteCarloStrategy.h"
 
-void MonteCarloStrategy::tickComputation()
+#include <cstdint>
+#include <iostream>
+
+MonteCarloStrategy::MonteCarloStrategy(const MonteCarloSettings& settings, bool useTranspositions, size_t maxTreeNodes, size_t maxTreeBytes)
+    : settings(settings), memoryBudget(maxTreeNodes, maxTreeBytes)
 {
-    // Run a few iterations of the Monte Carlo search.
-    for (int i = 0; i < 10; i++)
+    if (useTranspositions)
+        this->settings.transpositions = &transpositionTable;
+    if (memoryBudget.isLimited())
+        this->settings.memoryBudget = &memoryBudget;
+    // The leaf runs one of its playouts itself, the workers the others.
+    if (settings.parallelLeafPlayouts && settings.leafPlayouts > 1u)
     {
-        monteCarloTree.runIteration(board, 50u);
+        playoutWorkers = std::make_unique<LeafPlayoutWorkers>(settings.leafPlayouts - 1u);
+        this->settings.playoutWorkers = playoutWorkers.get();
     }
+}
+
+void MonteCarloStrategy::setMovePrior(std::unique_ptr<MovePrior> prior)
+{
+    movePrior = std::move(prior);
+    settings.movePrior = movePrior.get();
+}
 
-    // This must be set in this method if it's our turn.
-    confidence = 0.5f;
+void MonteCarloStrategy::measureTree(size_t& nodeCount, size_t& byteCount) const
+{
+    monteCarloTree.measureTree(nodeCount, byteCount);
+}
+
+void MonteCarloStrategy::tickComputation()
+{
+    // Run iterations of the Monte Carlo search until the time slice of the tick is used.
+    // A proven root has nothing left to search.
+    const TimePoint tickStart = std::chrono::system_clock::now();
+    const TimePoint deadline = TimeManagement::tickDeadline();
+    if (settings.sequentialHalving)
+        planSequentialHalving();
+    unsigned int iterations = 0u;
+    do
+    {
+        if (sequentialHalving.isActive())
+        {
+            if (sequentialHalving.roundFinished())
+                sequentialHalving.halve(monteCarloTree.getMoveStatistics());
+            monteCarloTree.runIteration(board, settings, sequentialHalving.nextChild());
+        }
+        else
+        {
+            monteCarloTree.runIteration(board, settings);
+        }
+        iterations++;
+    } while (std::chrono::system_clock::now() < deadline && monteCarloTree.provenResult() == ProvenResult::UNKNOWN);
+    iterationsPerSecond = iterations / Duration(std::chrono::system_clock::now() - tickStart).count();
+    iterationsSinceMove += iterations;
+    ticksSinceMove++;
+    enforceMemoryBudget();
+
+    // This must be set in this method if it's our turn. A proven position needs no more thinking.
+    confidence = monteCarloTree.provenResult() != ProvenResult::UNKNOWN ? 1.0f : 0.5f;
 }
 
 void MonteCarloStrategy::applyMoveToStrategy(const Move& move)
 {
+    if (ticksSinceMove > 0u)
+        std::cout << "Iterations per tick: " << iterationsSinceMove / ticksSinceMove << std::endl;
+    iterationsSinceMove = 0u;
+    ticksSinceMove = 0u;
+    sequentialHalving.stop();
     monteCarloTree = std::move(monteCarloTree.getNodeForMove(move));
+    if (settings.transpositions)
+    {
+        settings.transpositions->collectGarbage(monteCarloTree);
+        std::cout << "Transposition table nodes: " << settings.transpositions->size() << std::endl;
+    }
+    if (settings.memoryBudget)
+    {
+        measureTreeMemory();
+        std::cout << "Tree nodes: " << memoryBudget.usedNodes() << ", bytes: " << memoryBudget.usedBytes() << std::endl;
+    }
     monteCarloTree.printStats();
 }
 
 Move MonteCarloStrategy::getBestMove()
 {
     monteCarloTree.printStats();
-    return monteCarloTree.highestWinrateMove();
+    // PUCT leaves the moves with low priors with a few visits and noisy averages, the visits are the better measure.
+    if (sequentialHalving.isActive() && monteCarloTree.provenResult() == ProvenResult::UNKNOWN)
+        return sequentialHalving.bestCandidate(monteCarloTree.getMoveStatistics());
+    if (settings.movePrior)
+        return monteCarloTree.mostVisitedMove();
+    return monteCarloTree.highestWinrateMove(settings.minimaxWeight);
+}
+
+void MonteCarloStrategy::planSequentialHalving()
+{
+    // Pondering on the opponent's time keeps the normal selection, the halving plans our own thinking time.
+    if (sequentialHalving.isActive() || iterationsPerSecond <= 0.0f)
+        return;
+    const Duration timeLeft = moveTimeLeft();
+    if (timeLeft.count() <= 0.0f)
+        return;
+    // The root is expanded by its first iteration, a single move needs no halving.
+    const std::vector<MoveStatistics> rootStatistics = monteCarloTree.getMoveStatistics();
+    if (rootStatistics.size() < 2u)
+        return;
+    sequentialHalving.start(rootStatistics, (unsigned int)(iterationsPerSecond * timeLeft.count()));
+    std::cout << "Sequential halving over " << rootStatistics.size() << " moves in " << timeLeft.count() * 1000.0f << " ms" << std::endl;
+}
+
+void MonteCarloStrategy::enforceMemoryBudget()
+{
+    if (!settings.memoryBudget || !memoryBudget.exceeds(0.9f))
+        return;
+
+    // Prune the rarely visited subtrees, raising the bar until the tree is down to half
+    // of its budget, so that the search has room to grow again before the next pruning.
+    const unsigned int rootVisits = monteCarloTree.nodeVisits();
+    for (uint64_t maxVisits = 1u; maxVisits <= rootVisits && memoryBudget.exceeds(0.5f); maxVisits *= 2u)
+    {
+        monteCarloTree.pruneSubtrees((unsigned int)maxVisits);
+        if (settings.transpositions)
+            settings.transpositions->collectGarbage(monteCarloTree);
+        measureTreeMemory();
+    }
+}
+
+void MonteCarloStrategy::measureTreeMemory()
+{
+    size_t nodeCount, byteCount;
+    monteCarloTree.measureTree(nodeCount, byteCount);
+    memoryBudget.reset(nodeCount, byteCount);
 }
\ No newline at end of file
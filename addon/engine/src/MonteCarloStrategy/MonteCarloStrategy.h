@@ -1,15 +1,52 @@
 #pragma once
 
+#include <memory>
+
+#include "LeafPlayoutWorkers.h"
+#include "MonteCarloMemoryBudget.h"
 #include "MonteCarloNode.h"
+#include "MonteCarloSettings.h"
+#include "MonteCarloTranspositionTable.h"
+#include "MovePrior.h"
+#include "SequentialHalving.h"
 #include "../GreyPawnChess.h"
 
 class MonteCarloStrategy : public GreyPawnChess
 {
+public:
+    // The tree is limited to maxTreeNodes nodes and about maxTreeBytes bytes, zero means no limit.
+    MonteCarloStrategy(
+        const MonteCarloSettings& settings = MonteCarloSettings{ .maxMoveCount = 50u },
+        bool useTranspositions = false,
+        size_t maxTreeNodes = 0u,
+        size_t maxTreeBytes = 0u
+    );
+    // Switches the selection to PUCT with the priors of the given model. Only affects nodes expanded afterwards.
+    void setMovePrior(std::unique_ptr<MovePrior> prior);
+    // Counts the nodes of the current tree and estimates the memory they use.
+    void measureTree(size_t& nodeCount, size_t& byteCount) const;
+
 protected:
     void tickComputation() override;
     void applyMoveToStrategy(const Move& move) override;
     Move getBestMove() override;
 
 private:
+    // Prunes the least visited subtrees when the tree is close to its memory budget.
+    void enforceMemoryBudget();
+    void measureTreeMemory();
+    // Starts the sequential halving at the root once it's our turn and the search speed is known.
+    void planSequentialHalving();
+
     MonteCarloNode monteCarloTree;
-};
\ No newline at end of file
+    MonteCarloSettings settings;
+    MonteCarloTranspositionTable transpositionTable;
+    MonteCarloMemoryBudget memoryBudget;
+    std::unique_ptr<MovePrior> movePrior;
+    std::unique_ptr<LeafPlayoutWorkers> playoutWorkers;
+    SequentialHalving sequentialHalving;
+    // Measured search speed, the ticks are time-sliced.
+    unsigned int iterationsSinceMove = 0u;
+    unsigned int ticksSinceMove = 0u;
+    float iterationsPerSecond = 0.0f;
+};
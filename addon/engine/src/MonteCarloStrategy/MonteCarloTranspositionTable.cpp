@@ -0,0 +1,69 @@
+#include "MonteCarloTranspositionTable.h"
+
+#include <unordered_set>
+#include <vector>
+
+#include "MonteCarloNode.h"
+
+MonteCarloTranspositionTable::~MonteCarloTranspositionTable()
+{
+    clear();
+}
+
+std::shared_ptr<MonteCarloNode> MonteCarloTranspositionTable::findOrCreate(uint64_t positionHash)
+{
+    std::weak_ptr<MonteCarloNode>& entry = nodes[positionHash];
+    std::shared_ptr<MonteCarloNode> node = entry.lock();
+    if (!node)
+    {
+        node = std::make_shared<MonteCarloNode>();
+        entry = node;
+    }
+    return node;
+}
+
+void MonteCarloTranspositionTable::collectGarbage(const MonteCarloNode& root)
+{
+    // Mark everything reachable from the root. The graph may contain cycles.
+    std::unordered_set<const MonteCarloNode*> reachable;
+    std::vector<const MonteCarloNode*> openNodes = { &root };
+    while (openNodes.size() > 0)
+    {
+        const MonteCarloNode* node = openNodes.back();
+        openNodes.pop_back();
+        for (const std::shared_ptr<MonteCarloNode>& child : node->childNodes)
+        {
+            if (child && reachable.insert(child.get()).second)
+                openNodes.push_back(child.get());
+        }
+    }
+
+    for (auto it = nodes.begin(); it != nodes.end();)
+    {
+        std::shared_ptr<MonteCarloNode> node = it->second.lock();
+        if (node && reachable.count(node.get()) > 0)
+        {
+            ++it;
+            continue;
+        }
+        // An unreachable node can only be alive because of a cycle. Dropping its children breaks it.
+        if (node)
+            node->childNodes.clear();
+        it = nodes.erase(it);
+    }
+}
+
+void MonteCarloTranspositionTable::clear()
+{
+    for (auto& entry : nodes)
+    {
+        if (std::shared_ptr<MonteCarloNode> node = entry.second.lock())
+            node->childNodes.clear();
+    }
+    nodes.clear();
+}
+
+size_t MonteCarloTranspositionTable::size() const
+{
+    return nodes.size();
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+class MonteCarloNode;
+
+// Maps positions to the Monte Carlo nodes searching them, turning the search tree into a graph.
+// The nodes are owned by their parents, the table only keeps weak references to them.
+class MonteCarloTranspositionTable
+{
+public:
+    ~MonteCarloTranspositionTable();
+
+    std::shared_ptr<MonteCarloNode> findOrCreate(uint64_t positionHash);
+    // Forgets the nodes which cannot be reached from the new root. Transpositions can form cycles
+    // of shared nodes, those are broken here so that the nodes are actually released.
+    void collectGarbage(const MonteCarloNode& root);
+    void clear();
+    size_t size() const;
+
+private:
+    std::unordered_map<uint64_t, std::weak_ptr<MonteCarloNode>> nodes;
+};
@@ -0,0 +1,148 @@
+#include "MovePrior.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include "../Board.h"
+#include "../BoardEvaluator.h"
+
+namespace
+{
+    const char* const FEATURE_NAMES[MovePrior::FEATURE_COUNT] = {
+        "captureValue", "promotionValue", "check",
+        "pawnMove", "knightMove", "bishopMove", "rookMove", "queenMove", "kingMove",
+        "castling", "centralisation", "hangingValue", "escapeValue"
+    };
+
+    // Steps from the square to the closest of the four center squares.
+    int centerDistance(char square)
+    {
+        const int file = square % 8;
+        const int rank = square / 8;
+        return std::max(file < 4 ? 3 - file : file - 4, rank < 4 ? 3 - rank : rank - 4);
+    }
+}
+
+MovePrior::MovePrior()
+{
+    weights.fill(0.0f);
+    weights[CAPTURE_VALUE] = 0.6f;
+    weights[PROMOTION_VALUE] = 0.3f;
+    weights[CHECK] = 0.8f;
+    weights[KNIGHT_MOVE] = 0.3f;
+    weights[BISHOP_MOVE] = 0.3f;
+    weights[QUEEN_MOVE] = -0.2f;
+    weights[KING_MOVE] = -0.8f;
+    weights[CASTLING] = 1.5f;
+    weights[CENTRALISATION] = 0.4f;
+    weights[HANGING_VALUE] = -0.5f;
+    weights[ESCAPE_VALUE] = 0.4f;
+}
+
+bool MovePrior::loadFromFile(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    std::array<float, FEATURE_COUNT> loadedWeights = weights;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream lineStream(line);
+        std::string name;
+        float weight;
+        if (!(lineStream >> name) || name[0] == '#')
+            continue;
+        if (!(lineStream >> weight))
+            return false;
+        const char* const* featureIt = std::find_if(std::begin(FEATURE_NAMES), std::end(FEATURE_NAMES), [&name](const char* featureName) {
+            return name == featureName;
+        });
+        if (featureIt == std::end(FEATURE_NAMES))
+            return false;
+        loadedWeights[featureIt - std::begin(FEATURE_NAMES)] = weight;
+    }
+    weights = loadedWeights;
+    return true;
+}
+
+float MovePrior::getWeight(Feature feature) const
+{
+    return weights[feature];
+}
+
+void MovePrior::setWeight(Feature feature, float weight)
+{
+    weights[feature] = weight;
+}
+
+void MovePrior::computePriors(const Board& board, const std::vector<Move>& moves, std::vector<float>& priors) const
+{
+    priors.resize(moves.size());
+    std::array<float, FEATURE_COUNT> features;
+    float highestScore = -INFINITY;
+    for (size_t i = 0u; i < moves.size(); i++)
+    {
+        moveFeatures(board, moves[i], features);
+        float score = 0.0f;
+        for (int feature = 0; feature < FEATURE_COUNT; feature++)
+        {
+            score += weights[feature] * features[feature];
+        }
+        priors[i] = score;
+        highestScore = std::max(highestScore, score);
+    }
+
+    // Shifting by the highest score keeps the exponents from overflowing.
+    float total = 0.0f;
+    for (float& prior : priors)
+    {
+        prior = std::exp(prior - highestScore);
+        total += prior;
+    }
+    for (float& prior : priors)
+    {
+        prior /= total;
+    }
+}
+
+const char* MovePrior::featureName(Feature feature)
+{
+    return FEATURE_NAMES[feature];
+}
+
+void MovePrior::moveFeatures(const Board& board, const Move& move, std::array<float, FEATURE_COUNT>& features)
+{
+    features.fill(0.0f);
+    const Piece movingPiece = board.getSquare(move.from[0]);
+    const float movingValue = BoardEvaluator::pieceValue(movingPiece);
+    const Color opponent = board.getCurrentPlayer() == Color::WHITE ? Color::BLACK : Color::WHITE;
+
+    features[CAPTURE_VALUE] = BoardEvaluator::pieceValue(board.capturedPiece(move));
+    if (move.isPromotion())
+        features[PROMOTION_VALUE] = BoardEvaluator::pieceValue(move.promotion);
+    if (board.givesDirectCheck(move))
+        features[CHECK] = 1.0f;
+    switch (movingPiece & ~Piece::COLOR_MASK)
+    {
+        case Piece::PAWN: features[PAWN_MOVE] = 1.0f; break;
+        case Piece::KNIGHT: features[KNIGHT_MOVE] = 1.0f; break;
+        case Piece::BISHOP: features[BISHOP_MOVE] = 1.0f; break;
+        case Piece::ROOK: features[ROOK_MOVE] = 1.0f; break;
+        case Piece::QUEEN: features[QUEEN_MOVE] = 1.0f; break;
+        default: features[KING_MOVE] = 1.0f; break;
+    }
+    if (move.isCastling())
+    {
+        features[CASTLING] = 1.0f;
+        return;
+    }
+    features[CENTRALISATION] = float(centerDistance(move.from[0]) - centerDistance(move.to[0]));
+    if (board.isThreatened(move.to[0], opponent))
+        features[HANGING_VALUE] = move.isPromotion() ? BoardEvaluator::pieceValue(move.promotion) : movingValue;
+    if (board.isThreatened(move.from[0], opponent))
+        features[ESCAPE_VALUE] = movingValue;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "../Move.h"
+
+class Board;
+
+// Prior probabilities of the moves for the PUCT selection: a softmax over a linear model of cheap move features.
+class MovePrior
+{
+public:
+    enum Feature
+    {
+        CAPTURE_VALUE,      // Value of the captured piece in pawns.
+        PROMOTION_VALUE,    // Value of the piece promoted to in pawns.
+        CHECK,              // The moving piece gives check.
+        PAWN_MOVE, KNIGHT_MOVE, BISHOP_MOVE, ROOK_MOVE, QUEEN_MOVE, KING_MOVE,
+        CASTLING,
+        CENTRALISATION,     // How many steps closer to the center the piece moves.
+        HANGING_VALUE,      // Value of the moving piece if it lands on an attacked square.
+        ESCAPE_VALUE,       // Value of the moving piece if it leaves an attacked square.
+        FEATURE_COUNT
+    };
+
+    // Starts with hand-picked weights.
+    MovePrior();
+
+    // Reads lines of "<feature name> <weight>", the names being those of featureName. Lines starting with # are
+    // comments and features missing from the file keep their weights. Returns false if the file can't be read or
+    // has an unknown feature, the weights are left untouched then.
+    bool loadFromFile(const std::string& path);
+    float getWeight(Feature feature) const;
+    void setWeight(Feature feature, float weight);
+    // Softmax of the linear scores of the moves, written to priors in the order of the moves.
+    void computePriors(const Board& board, const std::vector<Move>& moves, std::vector<float>& priors) const;
+
+    static const char* featureName(Feature feature);
+    static void moveFeatures(const Board& board, const Move& move, std::array<float, FEATURE_COUNT>& features);
+
+private:
+    std::array<float, FEATURE_COUNT> weights;
+};
@@ -0,0 +1,126 @@
+#include "PlayoutPolicy.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "../Board.h"
+#include "../Random.h"
+
+namespace
+{
+    // Pawn, knight, bishop, rook, queen, king.
+    constexpr int PIECE_TYPES = 6;
+    constexpr std::array<unsigned int, PIECE_TYPES> PIECE_VALUES = { 1u, 3u, 3u, 5u, 9u, 0u };
+
+    constexpr unsigned int QUIET_MOVE_WEIGHT = 10u;
+    constexpr unsigned int CHECK_WEIGHT = 40u;
+    // Per pawn of the saved piece.
+    constexpr unsigned int ESCAPE_WEIGHT = 5u;
+    // Queen, knight, rook, bishop. Under-promotions are rarely the right choice.
+    constexpr unsigned int QUEEN_PROMOTION_WEIGHT = 200u;
+    constexpr unsigned int UNDER_PROMOTION_WEIGHT = 5u;
+
+    // MVV-LVA: the value of the victim counts the most, a cheaper attacker breaks the ties.
+    constexpr std::array<std::array<unsigned int, PIECE_TYPES>, PIECE_TYPES> CAPTURE_WEIGHTS = []() {
+        std::array<std::array<unsigned int, PIECE_TYPES>, PIECE_TYPES> weights{};
+        for (int victim = 0; victim < PIECE_TYPES; victim++)
+        {
+            for (int attacker = 0; attacker < PIECE_TYPES; attacker++)
+            {
+                weights[victim][attacker] = QUIET_MOVE_WEIGHT + 50u * PIECE_VALUES[victim] + 9u - PIECE_VALUES[attacker];
+            }
+        }
+        return weights;
+    }();
+
+    int pieceIndex(Piece piece)
+    {
+        switch (piece & ~Piece::COLOR_MASK)
+        {
+            case Piece::PAWN: return 0;
+            case Piece::KNIGHT: return 1;
+            case Piece::BISHOP: return 2;
+            case Piece::ROOK: return 3;
+            case Piece::QUEEN: return 4;
+            case Piece::KING: return 5;
+            default: return -1;
+        }
+    }
+}
+
+const PlayoutPolicy* PlayoutPolicy::byName(const std::string& name)
+{
+    static const HeavyPlayoutPolicy heavyPolicy;
+    if (name == "uniform")
+        return &uniform();
+    if (name == "heavy")
+        return &heavyPolicy;
+    return nullptr;
+}
+
+const PlayoutPolicy& PlayoutPolicy::uniform()
+{
+    static const UniformPlayoutPolicy uniformPolicy;
+    return uniformPolicy;
+}
+
+bool UniformPlayoutPolicy::selectMove(const Board& board, Move& move) const
+{
+    return board.findRandomMove(move);
+}
+
+bool HeavyPlayoutPolicy::selectMove(const Board& board, Move& move) const
+{
+    // The buffers are reused by every playout of the thread, so sampling doesn't allocate.
+    static thread_local std::vector<Move> moves;
+    static thread_local std::vector<unsigned int> cumulativeWeights;
+    board.findPossibleMoves(moves);
+    if (moves.size() == 0)
+        return false;
+
+    // Whether a piece is attacked only depends on its square, test each of them once.
+    const Color opponent = board.getCurrentPlayer() == Color::WHITE ? Color::BLACK : Color::WHITE;
+    signed char threatenedSquares[64];
+    std::fill(std::begin(threatenedSquares), std::end(threatenedSquares), -1);
+
+    cumulativeWeights.clear();
+    unsigned int totalWeight = 0u;
+    for (const Move& candidate : moves)
+    {
+        signed char& threatened = threatenedSquares[int(candidate.from[0])];
+        if (threatened == -1)
+            threatened = board.isThreatened(candidate.from[0], opponent) ? 1 : 0;
+        totalWeight += moveWeight(board, candidate, threatened == 1);
+        cumulativeWeights.push_back(totalWeight);
+    }
+
+    const unsigned int sample = Random::Range(0u, totalWeight - 1u);
+    size_t moveIdx = 0u;
+    while (sample >= cumulativeWeights[moveIdx])
+        moveIdx++;
+    move = moves[moveIdx];
+    return true;
+}
+
+unsigned int HeavyPlayoutPolicy::moveWeight(const Board& board, const Move& move, bool fromSquareThreatened)
+{
+    const int attacker = pieceIndex(board.getSquare(move.from[0]));
+    unsigned int weight = QUIET_MOVE_WEIGHT;
+    const Piece captured = board.capturedPiece(move);
+    if (captured != Piece::NONE)
+    {
+        const int victim = pieceIndex(captured);
+        // Taking a cheaper piece is only worth it when the exchange doesn't lose material.
+        // The exchange is only resolved then, as it's the slow part.
+        if (PIECE_VALUES[attacker] <= PIECE_VALUES[victim] || board.seeGE(move, 0.0f))
+            weight = CAPTURE_WEIGHTS[victim][attacker];
+    }
+    if (move.isPromotion())
+        weight += move.promotion == Piece::QUEEN ? QUEEN_PROMOTION_WEIGHT : UNDER_PROMOTION_WEIGHT;
+    if (board.givesDirectCheck(move))
+        weight += CHECK_WEIGHT;
+    if (fromSquareThreatened && !board.isThreatened(move.to[0], board.getCurrentPlayer() == Color::WHITE ? Color::BLACK : Color::WHITE))
+        weight += ESCAPE_WEIGHT * PIECE_VALUES[attacker];
+    return weight;
+}
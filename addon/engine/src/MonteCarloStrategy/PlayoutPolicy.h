@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+
+#include "../Move.h"
+
+class Board;
+
+// Chooses the moves of the Monte Carlo playouts. Policies are stateless and can be shared by any number of threads.
+class PlayoutPolicy
+{
+public:
+    virtual ~PlayoutPolicy() = default;
+    // Picks the next move of a playout. Returns false if the player in turn has no legal moves.
+    virtual bool selectMove(const Board& board, Move& move) const = 0;
+
+    // "uniform" or "heavy", nullptr for an unknown name.
+    static const PlayoutPolicy* byName(const std::string& name);
+    static const PlayoutPolicy& uniform();
+};
+
+// Every legal move is equally likely. Cheap, as only the chosen move is generated.
+class UniformPlayoutPolicy : public PlayoutPolicy
+{
+public:
+    bool selectMove(const Board& board, Move& move) const override;
+};
+
+// Generates all the legal moves and weights them by cheap features: captures by most valuable victim and
+// least valuable attacker, promotions, checks and moving an attacked piece to safety.
+class HeavyPlayoutPolicy : public PlayoutPolicy
+{
+public:
+    bool selectMove(const Board& board, Move& move) const override;
+    // Weight of the move in the current position, the chance of playing it is proportional to this.
+    static unsigned int moveWeight(const Board& board, const Move& move, bool fromSquareThreatened);
+};
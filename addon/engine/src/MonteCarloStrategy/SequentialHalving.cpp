@@ -0,0 +1,69 @@
+#include "SequentialHalving.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+
+void SequentialHalving::start(const std::vector<MoveStatistics>& rootStatistics, unsigned int iterationBudget)
+{
+    assert(rootStatistics.size() > 0u && "The root must be expanded before the halving starts.");
+    candidates.resize(rootStatistics.size());
+    for (size_t i = 0u; i < candidates.size(); i++)
+    {
+        candidates[i] = int(i);
+    }
+    // Every round gets the same share of the budget, there are as many rounds as halvings down to one candidate.
+    const unsigned int rounds = std::max(1u, (unsigned int)std::ceil(std::log2(float(candidates.size()))));
+    roundBudget = iterationBudget / rounds;
+    iterationsPerCandidate = std::max(1u, roundBudget / (unsigned int)candidates.size());
+    roundIterations = 0u;
+}
+
+void SequentialHalving::stop()
+{
+    candidates.clear();
+}
+
+bool SequentialHalving::isActive() const
+{
+    return candidates.size() > 0u;
+}
+
+bool SequentialHalving::roundFinished() const
+{
+    return candidates.size() > 1u && roundIterations >= iterationsPerCandidate * candidates.size();
+}
+
+void SequentialHalving::halve(const std::vector<MoveStatistics>& rootStatistics)
+{
+    std::stable_sort(candidates.begin(), candidates.end(), [&rootStatistics](int a, int b) {
+        return averagePoints(rootStatistics[a]) > averagePoints(rootStatistics[b]);
+    });
+    candidates.resize((candidates.size() + 1u) / 2u);
+    iterationsPerCandidate = std::max(1u, roundBudget / (unsigned int)candidates.size());
+    roundIterations = 0u;
+}
+
+int SequentialHalving::nextChild()
+{
+    // Round robin, so that every candidate has had the same share of the round whenever it ends.
+    return candidates[roundIterations++ % candidates.size()];
+}
+
+Move SequentialHalving::bestCandidate(const std::vector<MoveStatistics>& rootStatistics) const
+{
+    const int best = *std::max_element(candidates.begin(), candidates.end(), [&rootStatistics](int a, int b) {
+        return averagePoints(rootStatistics[a]) < averagePoints(rootStatistics[b]);
+    });
+    return rootStatistics[best].move;
+}
+
+size_t SequentialHalving::candidateCount() const
+{
+    return candidates.size();
+}
+
+float SequentialHalving::averagePoints(const MoveStatistics& stats)
+{
+    return stats.visits > 0u ? stats.points / stats.visits : 0.0f;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+
+#include "../Move.h"
+#include "MonteCarloNode.h"
+
+// Root move selection for small iteration budgets. The budget is split into rounds, each round spreads its share
+// evenly over the remaining candidate moves and then drops the worse half of them. The tree below the root
+// keeps its own selection.
+class SequentialHalving
+{
+public:
+    // Plans the rounds over the moves of an expanded root. The statistics give the order of the candidates.
+    void start(const std::vector<MoveStatistics>& rootStatistics, unsigned int iterationBudget);
+    void stop();
+    bool isActive() const;
+    // True when the iterations of the current round are done and the candidates should be halved.
+    bool roundFinished() const;
+    // Keeps the better half of the candidates by their average points and starts the next round.
+    void halve(const std::vector<MoveStatistics>& rootStatistics);
+    // Index of the root move the next iteration should go through.
+    int nextChild();
+    // The best remaining candidate, also before the last round is over.
+    Move bestCandidate(const std::vector<MoveStatistics>& rootStatistics) const;
+    size_t candidateCount() const;
+
+private:
+    static float averagePoints(const MoveStatistics& stats);
+
+    std::vector<int> candidates;
+    unsigned int iterationsPerCandidate = 0u;
+    unsigned int roundIterations = 0u;
+    unsigned int roundBudget = 0u;
+};
@@ -0,0 +1,136 @@
+#include "UCBKernel.h"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define UCB_KERNEL_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define UCB_KERNEL_SSE2 1
+#endif
+
+namespace UCBKernel
+{
+    namespace
+    {
+        constexpr unsigned int INVERSE_SQRT_TABLE_SIZE = 4096u;
+
+        const std::array<float, INVERSE_SQRT_TABLE_SIZE> inverseSqrtTable = []() {
+            std::array<float, INVERSE_SQRT_TABLE_SIZE> table;
+            table[0] = FLT_MAX;
+            for (unsigned int visits = 1u; visits < INVERSE_SQRT_TABLE_SIZE; visits++)
+            {
+                table[visits] = 1.0f / std::sqrt(float(visits));
+            }
+            return table;
+        }();
+
+        float scoreChild(unsigned int visits, float points, float explorationScale)
+        {
+            if (visits == 0u)
+                return FLT_MAX;
+            return 1.0f - points / float(visits) + exploration(visits, explorationScale);
+        }
+    }
+
+    float inverseSqrt(unsigned int visits)
+    {
+        if (visits < INVERSE_SQRT_TABLE_SIZE)
+            return inverseSqrtTable[visits];
+        return 1.0f / std::sqrt(float(visits));
+    }
+
+    float explorationScale(unsigned int parentVisits)
+    {
+        return 2.0f * std::sqrt(std::log(float(parentVisits)));
+    }
+
+    float exploration(unsigned int visits, float explorationScale)
+    {
+        return explorationScale * inverseSqrt(visits);
+    }
+
+    float scoreChildren(const unsigned int* visits, const float* points, int childCount, float explorationScale, float* scores)
+    {
+        float bestScore = -FLT_MAX;
+        int i = 0;
+#if UCB_KERNEL_AVX2
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 unvisitedScore = _mm256_set1_ps(FLT_MAX);
+        const __m256 scale = _mm256_set1_ps(explorationScale);
+        const __m256i lastTableIndex = _mm256_set1_epi32(int(INVERSE_SQRT_TABLE_SIZE - 1u));
+        __m256 bestScores = _mm256_set1_ps(-FLT_MAX);
+        for (; i + 8 <= childCount; i += 8)
+        {
+            const __m256i childVisits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(visits + i));
+            const __m256 n = _mm256_cvtepi32_ps(childVisits);
+            const __m256 exploitation = _mm256_sub_ps(one, _mm256_div_ps(_mm256_loadu_ps(points + i), n));
+            // exploration() of every lane: gathered from the table, only visit counts past its end need a square root.
+            __m256 inverseRoots = _mm256_i32gather_ps(
+                inverseSqrtTable.data(), _mm256_min_epu32(childVisits, lastTableIndex), sizeof(float));
+            const __m256 pastTable = _mm256_castsi256_ps(_mm256_cmpgt_epi32(childVisits, lastTableIndex));
+            if (_mm256_movemask_ps(pastTable))
+                inverseRoots = _mm256_blendv_ps(inverseRoots, _mm256_div_ps(one, _mm256_sqrt_ps(n)), pastTable);
+            const __m256 exploration = _mm256_mul_ps(scale, inverseRoots);
+            // Lanes of unvisited children divided by zero, replace them.
+            const __m256 unvisited = _mm256_castsi256_ps(_mm256_cmpeq_epi32(childVisits, _mm256_setzero_si256()));
+            const __m256 score = _mm256_blendv_ps(_mm256_add_ps(exploitation, exploration), unvisitedScore, unvisited);
+            _mm256_storeu_ps(scores + i, score);
+            bestScores = _mm256_max_ps(bestScores, score);
+        }
+        alignas(32) float laneScores[8];
+        _mm256_store_ps(laneScores, bestScores);
+        for (float laneScore : laneScores)
+            bestScore = std::max(bestScore, laneScore);
+#elif UCB_KERNEL_SSE2
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 unvisitedScore = _mm_set1_ps(FLT_MAX);
+        __m128 bestScores = _mm_set1_ps(-FLT_MAX);
+        for (; i + 4 <= childCount; i += 4)
+        {
+            const __m128i childVisits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(visits + i));
+            const __m128 n = _mm_cvtepi32_ps(childVisits);
+            const __m128 exploitation = _mm_sub_ps(one, _mm_div_ps(_mm_loadu_ps(points + i), n));
+            // SSE2 has no gather, the table is read lane by lane.
+            const __m128 explorations = _mm_set_ps(exploration(visits[i + 3], explorationScale),
+                exploration(visits[i + 2], explorationScale), exploration(visits[i + 1], explorationScale),
+                exploration(visits[i], explorationScale));
+            // Lanes of unvisited children divided by zero, replace them.
+            const __m128 unvisited = _mm_castsi128_ps(_mm_cmpeq_epi32(childVisits, _mm_setzero_si128()));
+            const __m128 visitedScore = _mm_add_ps(exploitation, explorations);
+            const __m128 score = _mm_or_ps(_mm_and_ps(unvisited, unvisitedScore), _mm_andnot_ps(unvisited, visitedScore));
+            _mm_storeu_ps(scores + i, score);
+            bestScores = _mm_max_ps(bestScores, score);
+        }
+        alignas(16) float laneScores[4];
+        _mm_store_ps(laneScores, bestScores);
+        for (float laneScore : laneScores)
+            bestScore = std::max(bestScore, laneScore);
+#endif
+        // The remaining children, or all of them without SIMD support.
+        for (; i < childCount; i++)
+        {
+            scores[i] = scoreChild(visits[i], points[i], explorationScale);
+            bestScore = std::max(bestScore, scores[i]);
+        }
+        return bestScore;
+    }
+
+    float scorePUCTChildren(const unsigned int* visits, const float* points, const float* priors, int childCount,
+        float explorationScale, float unvisitedValue, float* scores)
+    {
+        // Only used for children that got a prior at expansion, the plain loop vectorizes well enough.
+        float bestScore = -FLT_MAX;
+        for (int i = 0; i < childCount; i++)
+        {
+            const float exploitation = visits[i] == 0u ? unvisitedValue : 1.0f - points[i] / float(visits[i]);
+            scores[i] = exploitation + explorationScale * priors[i] / float(1u + visits[i]);
+            bestScore = std::max(bestScore, scores[i]);
+        }
+        return bestScore;
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+// Scores children for the UCB1 selection straight from the parent's statistic arrays.
+// Uses AVX2 or SSE2 when the compiler targets them and plain C++ otherwise.
+namespace UCBKernel
+{
+    // Upper bound for the amount of children, there are never more legal moves than this in chess.
+    constexpr int MAX_CHILDREN = 256;
+
+    // Writes UCB1 = (1 - points / visits) + explorationScale / sqrt(visits) of every child to scores.
+    // Points are from the child's point of view. Unvisited children get FLT_MAX. Returns the highest score.
+    float scoreChildren(const unsigned int* visits, const float* points, int childCount, float explorationScale, float* scores);
+
+    // Writes PUCT = (1 - points / visits) + explorationScale * prior / (1 + visits) of every child to scores.
+    // Unvisited children get unvisitedValue as their exploitation term. Returns the highest score.
+    float scorePUCTChildren(const unsigned int* visits, const float* points, const float* priors, int childCount,
+        float explorationScale, float unvisitedValue, float* scores);
+
+    // 1 / sqrt(visits), from a table for small visit counts.
+    float inverseSqrt(unsigned int visits);
+
+    // UCB1's exploration term 2 * sqrt(ln(N) / n) is split into 2 * sqrt(ln(N)), shared by all the children of a parent
+    // with N visits, and 1 / sqrt(n).
+    float explorationScale(unsigned int parentVisits);
+    // The exploration term of a visited child. The scalar and the SIMD scoring both use it.
+    float exploration(unsigned int visits, float explorationScale);
+}
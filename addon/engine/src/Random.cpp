@@ -2,28 +2,115 @@
 
 #include <assert.h>
 #include <chrono>
-#include <random>
+#include <functional>
+#include <thread>
+
+namespace
+{
+    // xoshiro256** by David Blackman and Sebastiano Vigna, https://prng.di.unimi.it/
+    class Xoshiro256
+    {
+    public:
+        explicit Xoshiro256(uint64_t seed)
+        {
+            setSeed(seed);
+        }
+
+        void setSeed(uint64_t seed)
+        {
+            // The state is filled with splitmix64, as recommended by the authors. It is never all zeros.
+            for (uint64_t& word : state)
+            {
+                seed += 0x9e3779b97f4a7c15ull;
+                uint64_t z = seed;
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+                word = z ^ (z >> 31);
+            }
+        }
+
+        uint64_t next()
+        {
+            const uint64_t result = rotateLeft(state[1] * 5u, 7) * 9u;
+            const uint64_t t = state[1] << 17;
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= t;
+            state[3] = rotateLeft(state[3], 45);
+            return result;
+        }
+
+    private:
+        static uint64_t rotateLeft(uint64_t x, int k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        uint64_t state[4];
+    };
+
+    // Each thread gets its own generator, seeded with the thread id so that threads started at the same time diverge.
+    Xoshiro256& threadGenerator()
+    {
+        static thread_local Xoshiro256 generator(
+            (uint64_t)std::chrono::system_clock::now().time_since_epoch().count() ^
+            (uint64_t)std::hash<std::thread::id>()(std::this_thread::get_id())
+        );
+        return generator;
+    }
+
+    // Unbiased integer in [0, range) with Lemire's multiply-shift method. A zero range means all 2^32 values.
+    uint32_t boundedRandom(uint32_t range)
+    {
+        Xoshiro256& generator = threadGenerator();
+        if (range == 0u)
+            return (uint32_t)(generator.next() >> 32);
+
+        uint64_t product = (generator.next() >> 32) * range;
+        uint32_t low = (uint32_t)product;
+        if (low < range)
+        {
+            // Reject the few products that would make the smallest results more likely than the others.
+            const uint32_t threshold = (0u - range) % range;
+            while (low < threshold)
+            {
+                product = (generator.next() >> 32) * range;
+                low = (uint32_t)product;
+            }
+        }
+        return (uint32_t)(product >> 32);
+    }
+}
 
 int Random::Range(int min, int max)
 {
     assert(min <= max);
-    static std::default_random_engine rng((unsigned int)std::chrono::system_clock::now().time_since_epoch().count());
-    std::uniform_int_distribution<int> distribution(min, max);
-    return distribution(rng);
+    const uint32_t range = (uint32_t)max - (uint32_t)min + 1u;
+    return (int)((uint32_t)min + boundedRandom(range));
 }
 
 unsigned int Random::Range(unsigned int min, unsigned int max)
 {
     assert(min <= max);
-    static std::default_random_engine rng((unsigned int)std::chrono::system_clock::now().time_since_epoch().count());
-    std::uniform_int_distribution<unsigned int> distribution(min, max);
-    return distribution(rng);
+    return min + boundedRandom(max - min + 1u);
 }
 
 float Random::Range(float min, float max)
 {
     assert(min <= max);
-    static std::default_random_engine rng((unsigned int)std::chrono::system_clock::now().time_since_epoch().count());
-    std::uniform_real_distribution<float> distribution(min, max);
-    return distribution(rng);
+    // The upper 24 bits fill the mantissa of a float in [0, 1) exactly.
+    const float unit = (threadGenerator().next() >> 40) * (1.0f / 16777216.0f);
+    return min + unit * (max - min);
+}
+
+uint64_t Random::Next()
+{
+    return threadGenerator().next();
+}
+
+void Random::Seed(uint64_t seed)
+{
+    threadGenerator().setSeed(seed);
 }
@@ -1,9 +1,17 @@
 #pragma once
 
+#include <cstdint>
+
+// Random numbers from a xoshiro256** generator. Every thread has a generator of its own,
+// so the functions are thread-safe without locking and threads don't repeat each other's numbers.
 class Random
 {
 public:
     static int Range(int min, int max);
     static unsigned int Range(unsigned int min, unsigned int max);
     static float Range(float min, float max);
-};
\ No newline at end of file
+    // Random 64 bits.
+    static uint64_t Next();
+    // Restarts the generator of the calling thread from the given seed, e.g. to make a search reproducible.
+    static void Seed(uint64_t seed);
+};
@@ -0,0 +1,193 @@
+#include "RootParallelMonteCarloStrategy.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <iostream>
+
+RootParallelMonteCarloStrategy::RootParallelMonteCarloStrategy(const MonteCarloSettings& settings, unsigned int threadCount,
+    unsigned int mergeIntervalTicks)
+    : settings(settings)
+    , mergeIntervalTicks(mergeIntervalTicks)
+{
+    // The trees are searched at the same time, nothing they write may be shared.
+    this->settings.transpositions = nullptr;
+    this->settings.memoryBudget = nullptr;
+    this->settings.playoutWorkers = nullptr;
+    this->settings.parallelLeafPlayouts = false;
+    if (threadCount == 0u)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    trees.resize(threadCount);
+    // The first tree is searched by the thread ticking the strategy, the others by helpers started only once.
+    for (size_t i = 1u; i < trees.size(); i++)
+    {
+        helperThreads.emplace_back(&RootParallelMonteCarloStrategy::helperLoop, this, i);
+    }
+}
+
+RootParallelMonteCarloStrategy::~RootParallelMonteCarloStrategy()
+{
+    {
+        std::lock_guard<std::mutex> lock(tickMutex);
+        stopping = true;
+    }
+    tickStarted.notify_all();
+    for (std::thread& helperThread : helperThreads)
+    {
+        helperThread.join();
+    }
+}
+
+void RootParallelMonteCarloStrategy::tickComputation()
+{
+    // Every thread runs iterations until the shared deadline of the tick.
+    // The board is only read during the tick, every iteration works on its own copy of it.
+    const TimePoint deadline = TimeManagement::tickDeadline();
+    {
+        std::lock_guard<std::mutex> lock(tickMutex);
+        tickDeadline = deadline;
+        helpersRunning = unsigned(helperThreads.size());
+        helperIterations = 0u;
+        tickNumber++;
+    }
+    tickStarted.notify_all();
+    unsigned int iterations = runIterations(trees[0], deadline);
+    {
+        std::unique_lock<std::mutex> lock(tickMutex);
+        tickFinished.wait(lock, [this]() { return helpersRunning == 0u; });
+    }
+    iterations += helperIterations;
+    iterationsSinceMove += iterations;
+    ticksSinceMove++;
+
+    if (mergeIntervalTicks > 0u && ++ticksSinceMerge >= mergeIntervalTicks)
+    {
+        synchronizeRoots();
+        ticksSinceMerge = 0u;
+    }
+
+    // This must be set in this method if it's our turn. A proven position needs no more thinking.
+    confidence = trees[0].provenResult() != ProvenResult::UNKNOWN ? 1.0f : 0.5f;
+}
+
+unsigned int RootParallelMonteCarloStrategy::runIterations(MonteCarloNode& tree, TimePoint deadline)
+{
+    unsigned int iterations = 0u;
+    do
+    {
+        tree.runIteration(board, settings);
+        iterations++;
+    } while (std::chrono::system_clock::now() < deadline && tree.provenResult() == ProvenResult::UNKNOWN);
+    return iterations;
+}
+
+void RootParallelMonteCarloStrategy::helperLoop(size_t treeIdx)
+{
+    uint64_t lastTick = 0u;
+    std::unique_lock<std::mutex> lock(tickMutex);
+    while (true)
+    {
+        tickStarted.wait(lock, [&]() { return stopping || tickNumber != lastTick; });
+        if (stopping)
+            return;
+        lastTick = tickNumber;
+        const TimePoint deadline = tickDeadline;
+
+        lock.unlock();
+        helperIterations += runIterations(trees[treeIdx], deadline);
+        lock.lock();
+        if (--helpersRunning == 0u)
+            tickFinished.notify_one();
+    }
+}
+
+void RootParallelMonteCarloStrategy::applyMoveToStrategy(const Move& move)
+{
+    if (ticksSinceMove > 0u)
+        std::cout << "Iterations per tick, all threads: " << iterationsSinceMove / ticksSinceMove << std::endl;
+    iterationsSinceMove = 0u;
+    ticksSinceMove = 0u;
+    for (MonteCarloNode& tree : trees)
+    {
+        tree = std::move(tree.getNodeForMove(move));
+    }
+    ticksSinceMerge = 0u;
+    trees[0].printStats();
+}
+
+Move RootParallelMonteCarloStrategy::getBestMove()
+{
+    // A proven win is played right away and proven losses are avoided, as in a single tree.
+    std::vector<MoveStatistics> mergedStats = mergeRootStatistics(trees);
+    float bestWinRate = -1.0f;
+    Move bestMove;
+    unsigned int totalVisits = 0u;
+    for (const MoveStatistics& stats : mergedStats)
+    {
+        totalVisits += stats.visits;
+        if (stats.result == ProvenResult::WIN)
+            return stats.move;
+        if (stats.visits == 0u)
+            continue;
+
+        float winRate = stats.points / stats.visits;
+        if (stats.result == ProvenResult::DRAW)
+            winRate = 0.5f;
+        else if (stats.result == ProvenResult::LOSS)
+            winRate = -0.5f; // Only played if every move loses.
+        if (winRate > bestWinRate)
+        {
+            bestWinRate = winRate;
+            bestMove = stats.move;
+        }
+    }
+    assert(bestWinRate != -1.0f && "Shouldn't call this function if no iterations have been run.");
+    std::cout << "Root parallel trees: " << trees.size() << ", merged root visits: " << totalVisits << std::endl;
+    return bestMove;
+}
+
+std::vector<MoveStatistics> RootParallelMonteCarloStrategy::mergeRootStatistics(const std::vector<MonteCarloNode>& trees)
+{
+    std::vector<MoveStatistics> mergedStats;
+    for (const MonteCarloNode& tree : trees)
+    {
+        for (const MoveStatistics& stats : tree.getMoveStatistics())
+        {
+            auto merged = std::find_if(mergedStats.begin(), mergedStats.end(), [&stats](MoveStatistics& other) {
+                return other.move == stats.move;
+            });
+            if (merged == mergedStats.end())
+            {
+                mergedStats.push_back(stats);
+                continue;
+            }
+            merged->visits += stats.visits;
+            merged->points += stats.points;
+            if (merged->result == ProvenResult::UNKNOWN)
+                merged->result = stats.result;
+        }
+    }
+    return mergedStats;
+}
+
+std::vector<MoveStatistics> RootParallelMonteCarloStrategy::averageRootStatistics(std::vector<MoveStatistics> mergedStats,
+    unsigned int treeCount)
+{
+    // The visits are rounded up, so a move visited by one tree only stays visited.
+    for (MoveStatistics& stats : mergedStats)
+    {
+        float meanPoints = stats.visits > 0u ? stats.points / stats.visits : 0.0f;
+        stats.visits = (stats.visits + treeCount - 1u) / treeCount;
+        stats.points = meanPoints * stats.visits;
+    }
+    return mergedStats;
+}
+
+void RootParallelMonteCarloStrategy::synchronizeRoots()
+{
+    // Every tree gets the average of the merged statistics.
+    const std::vector<MoveStatistics> sharedStats = averageRootStatistics(mergeRootStatistics(trees), (unsigned int)trees.size());
+    for (MonteCarloNode& tree : trees)
+    {
+        tree.setMoveStatistics(sharedStats);
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../GreyPawnChess.h"
+#include "../MonteCarloStrategy/MonteCarloNode.h"
+#include "../MonteCarloStrategy/MonteCarloSettings.h"
+
+// Runs an independent Monte Carlo tree on each thread. The trees only meet when the statistics
+// of the root moves are merged, so no locking is needed while searching.
+class RootParallelMonteCarloStrategy : public GreyPawnChess
+{
+public:
+    // Zero threads means one per hardware thread. Zero merge interval merges only when a move is made.
+    // The trees search with the given settings, except for the parts that would be shared between the threads:
+    // the transposition table, the memory budget and the leaf playout workers.
+    RootParallelMonteCarloStrategy(
+        const MonteCarloSettings& settings = MonteCarloSettings{ .maxMoveCount = 50u },
+        unsigned int threadCount = 0u,
+        unsigned int mergeIntervalTicks = 5u
+    );
+    ~RootParallelMonteCarloStrategy();
+
+    // Sums the statistics of the root moves over the trees. A result proven by any of the trees holds for all of them.
+    static std::vector<MoveStatistics> mergeRootStatistics(const std::vector<MonteCarloNode>& trees);
+    // The share of merged statistics every tree gets, so that the total amount of visits stays about the same.
+    static std::vector<MoveStatistics> averageRootStatistics(std::vector<MoveStatistics> mergedStats, unsigned int treeCount);
+
+protected:
+    void tickComputation() override;
+    void applyMoveToStrategy(const Move& move) override;
+    Move getBestMove() override;
+
+private:
+    // Iterates the tree until the deadline or until its root is proven, returns the amount of iterations.
+    unsigned int runIterations(MonteCarloNode& tree, TimePoint deadline);
+    // The helper threads live as long as the strategy and wait between the ticks.
+    void helperLoop(size_t treeIdx);
+    // Shares the merged root statistics with every tree, so that each of them can focus on the promising moves.
+    void synchronizeRoots();
+
+    MonteCarloSettings settings;
+    std::vector<MonteCarloNode> trees;
+    unsigned int mergeIntervalTicks;
+    unsigned int ticksSinceMerge = 0u;
+    // Measured search speed, the ticks are time-sliced.
+    unsigned int iterationsSinceMove = 0u;
+    unsigned int ticksSinceMove = 0u;
+
+    std::vector<std::thread> helperThreads;
+    std::mutex tickMutex;
+    std::condition_variable tickStarted;
+    std::condition_variable tickFinished;
+    // Counts the ticks, so that a helper can tell a new tick from a spurious wake up.
+    uint64_t tickNumber = 0u;
+    TimePoint tickDeadline;
+    unsigned int helpersRunning = 0u;
+    bool stopping = false;
+    std::atomic<unsigned int> helperIterations = 0u;
+};
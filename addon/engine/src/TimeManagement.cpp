@@ -2,12 +2,19 @@
 
 #include "TimeManagement.h"
 
+namespace
+{
+    int expectedMovesLeft(int moveNumber)
+    {
+        return 10 + std::max(0, 60 - moveNumber);
+    }
+}
+
 namespace TimeManagement
 {
     // Placeholder implementation
     bool timeToMove(float timeLeftMs, float incrementMs, int moveNumber, Duration timeUsed, float confidence)
     {
-        int expectedMovesLeft = 10 + std::max(0, 60 - moveNumber);
         if (confidence > 0.9f)
             return true;
 
@@ -15,9 +22,19 @@ namespace TimeManagement
             return false;
 
         // Use no more than 5% of remaining time.
-        if (timeUsed.count() * 1000 > timeLeftMs / expectedMovesLeft)
+        if (timeUsed.count() * 1000 > timeLeftMs / expectedMovesLeft(moveNumber))
             return true;
 
         return false;
     }
+
+    float moveTimeBudgetMs(float timeLeftMs, float incrementMs, int moveNumber)
+    {
+        return std::max(incrementMs, timeLeftMs / expectedMovesLeft(moveNumber));
+    }
+
+    TimePoint tickDeadline()
+    {
+        return std::chrono::system_clock::now() + TICK_TIME_SLICE;
+    }
 }
\ No newline at end of file
@@ -7,5 +7,13 @@ typedef std::chrono::duration<float> Duration;
 
 namespace TimeManagement
 {
+    // Length of a single computation tick. Short, so that the worker notices new moves and
+    // the decision to move quickly, but long enough that checking the clock costs next to nothing.
+    constexpr std::chrono::milliseconds TICK_TIME_SLICE(5);
+
     bool timeToMove(float timeLeftMs, float incrementMs, int moveNumber, Duration timeUsed, float confidence);
+    // Thinking time timeToMove gives an unsure engine for the move, in milliseconds.
+    float moveTimeBudgetMs(float timeLeftMs, float incrementMs, int moveNumber);
+    // The point in time when a tick started now should end.
+    TimePoint tickDeadline();
 }
\ No newline at end of file
@@ -2,7 +2,6 @@
 
 #include <assert.h>
 #include <iostream>
-#include <climits>
 
 #include "Random.h"
 
@@ -52,7 +51,7 @@ void ZobristHash::initHash(
     }
 }
 
-unsigned int ZobristHash::getHash() const
+uint64_t ZobristHash::getHash() const
 {
     return hash;
 }
@@ -146,20 +145,19 @@ int ZobristHash::zobristPieceKey(Piece piece)
     }
 }
 
-unsigned int* ZobristHash::getZobristHashTable()
+uint64_t* ZobristHash::getZobristHashTable()
 {
     // 64 squares, 12 different pieces, 1 for player in turn, 4 for castling rights, 8 for en passant file
-    static unsigned int zobristHashTable[64 * 12 + 1 + 4 + 8];
-    static bool initialized = false;
-    if (!initialized)
-    {
-        // If the hash is not yet calculated, calculate it.
-        constexpr int nNumbers = 64 * 12 + 1 + 4 + 8;
+    constexpr int nNumbers = 64 * 12 + 1 + 4 + 8;
+    static uint64_t zobristHashTable[nNumbers];
+    // Initialization of a local static is thread-safe, searches on several threads may be the first users.
+    static const bool initialized = []() {
         for (int i = 0; i < nNumbers; i++)
         {
-            zobristHashTable[i] = Random::Range(0u, UINT_MAX);
+            zobristHashTable[i] = Random::Next();
         }
-        initialized = true;
-    }
+        return true;
+    }();
+    (void)initialized;
     return zobristHashTable;
 }
\ No newline at end of file
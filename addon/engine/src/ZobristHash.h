@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include "GameState.h"
 #include "Piece.h"
 
@@ -15,14 +17,14 @@ public:
         bool blackCanCastleQueen, 
         int enPassant
     );
-    unsigned int getHash() const;
+    uint64_t getHash() const;
     void toggleCastlingRights(Color player, char kingOrQueen);
     void toggleEnPassant(int enPassantFile);
     void togglePiece(char square, Piece piece);
     void togglePlayerInTurn();
-    static unsigned int* getZobristHashTable();
+    static uint64_t* getZobristHashTable();
     static int zobristPieceKey(Piece piece);
 
 private:
-    unsigned int hash = 0u;
+    uint64_t hash = 0u;
 };
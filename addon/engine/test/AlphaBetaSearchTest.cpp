@@ -0,0 +1,169 @@
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../src/AlphaBetaStrategy/AlphaBetaSearch.h"
+#include "../src/Board.h"
+
+TEST(AlphaBetaSearchTest, FindsMateInOne)
+{
+	const Board board = Board::buildFromFEN("3q3k/5K2/5NP1/8/8/5r2/8/8 w - - 0 1");
+	const SearchResult result = AlphaBetaSearch().searchDepth(board, 3u);
+	EXPECT_EQ(result.bestMove.asUCIstr(), "g6g7");
+	EXPECT_EQ(result.score, AlphaBetaSearch::MATE_SCORE - 1);
+	// The capture search at the leaves searches the evasions of the check and sees the mate.
+	// Searching deeper than that can't change a mate.
+	EXPECT_EQ(result.depth, 1u);
+}
+
+TEST(AlphaBetaSearchTest, FindsMateInThree)
+{
+	// Black can delay the mate by blocking the check with the rook and the queen.
+	const Board board = Board::buildFromFEN("2r4k/6pp/5p2/7K/2R1r3/q4n2/2R5/8 w - - 0 1");
+	const SearchResult result = AlphaBetaSearch().searchDepth(board, 8u);
+	EXPECT_EQ(result.bestMove.asUCIstr(), "c4c8");
+	EXPECT_EQ(result.score, AlphaBetaSearch::MATE_SCORE - 5);
+	// Every check after the first move is a capture, so the capture search sees the whole mate with its distance.
+	EXPECT_EQ(result.depth, 1u);
+}
+
+TEST(AlphaBetaSearchTest, AvoidsDefendedPawn)
+{
+	// Taking the pawn on d6 loses the queen to c7, the rook on a5 is free.
+	const Board board = Board::buildFromFEN("4k3/2p5/3p4/r7/8/8/3Q4/7K w - - 0 1");
+	const SearchResult result = AlphaBetaSearch().searchDepth(board, 3u);
+	EXPECT_EQ(result.bestMove.asUCIstr(), "d2a5");
+	EXPECT_EQ(result.depth, 3u);
+	EXPECT_GT(result.nodes, 0u);
+}
+
+TEST(AlphaBetaSearchTest, StopsWhenAsked)
+{
+	const Board board;
+	std::atomic<bool> stop = false;
+	unsigned int completedDepth = 0u;
+	AlphaBetaSearch search;
+	search.run(board, stop, 64u, [&stop, &completedDepth](const SearchResult& result) {
+		EXPECT_TRUE(result.bestMove.isValid());
+		completedDepth = result.depth;
+		if (result.depth == 2u)
+			stop = true;
+	});
+	EXPECT_EQ(completedDepth, 2u);
+}
+
+TEST(AlphaBetaSearchTest, TableSavesNodes)
+{
+	const Board board = Board::buildFromFEN("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+	const SearchResult withoutTable = AlphaBetaSearch().searchDepth(board, 5u);
+	TranspositionTable table(16u);
+	const SearchResult withTable = AlphaBetaSearch(&table).searchDepth(board, 5u);
+	EXPECT_EQ(withTable.depth, 5u);
+	EXPECT_LT(withTable.nodes, withoutTable.nodes);
+	// The mate is found the same with the scores stored relative to the positions.
+	table.clear();
+	const Board mateBoard = Board::buildFromFEN("2r4k/6pp/5p2/7K/2R1r3/q4n2/2R5/8 w - - 0 1");
+	const SearchResult mate = AlphaBetaSearch(&table).searchDepth(mateBoard, 8u);
+	EXPECT_EQ(mate.bestMove.asUCIstr(), "c4c8");
+	EXPECT_EQ(mate.score, AlphaBetaSearch::MATE_SCORE - 5);
+}
+
+TEST(AlphaBetaSearchTest, HelpersSkipDepths)
+{
+	const Board board;
+	TranspositionTable table(16u);
+	const std::atomic<bool> stop = false;
+	std::vector<unsigned int> mainDepths;
+	AlphaBetaSearch(&table, 0u).run(board, stop, 4u, [&mainDepths](const SearchResult& result) {
+		mainDepths.push_back(result.depth);
+	});
+	EXPECT_EQ(mainDepths, std::vector<unsigned int>({ 1u, 2u, 3u, 4u }));
+	std::vector<unsigned int> helperDepths;
+	AlphaBetaSearch(&table, 1u).run(board, stop, 4u, [&helperDepths](const SearchResult& result) {
+		helperDepths.push_back(result.depth);
+	});
+	EXPECT_EQ(helperDepths, std::vector<unsigned int>({ 1u, 2u, 4u }));
+}
+
+TEST(AlphaBetaSearchTest, HelpersShareTable)
+{
+	const Board board = Board::buildFromFEN("2r4k/6pp/5p2/7K/2R1r3/q4n2/2R5/8 w - - 0 1");
+	TranspositionTable table(16u);
+	std::atomic<bool> stop = false;
+	std::vector<std::thread> helpers;
+	for (unsigned int i = 1u; i < 4u; i++)
+	{
+		helpers.emplace_back([&board, &table, &stop, i]() {
+			AlphaBetaSearch(&table, i).run(board, stop, 8u, [](const SearchResult&) {});
+		});
+	}
+	const SearchResult result = AlphaBetaSearch(&table, 0u).searchDepth(board, 8u);
+	stop = true;
+	for (std::thread& helper : helpers)
+	{
+		helper.join();
+	}
+	EXPECT_EQ(result.bestMove.asUCIstr(), "c4c8");
+	EXPECT_EQ(result.score, AlphaBetaSearch::MATE_SCORE - 5);
+}
+
+TEST(AlphaBetaSearchTest, ResolvesCapturesAtLeaves)
+{
+	// At depth one the rook on g5 looks better than the knight, until the pawn takes the queen back.
+	const Board board = Board::buildFromFEN("4k3/8/7p/6r1/1n6/8/3Q4/7K w - - 0 1");
+	const SearchResult result = AlphaBetaSearch().searchDepth(board, 1u);
+	EXPECT_EQ(result.bestMove.asUCIstr(), "d2b4");
+	EXPECT_EQ(result.score, 300);
+}
+
+AlphaBetaSettings selectiveSettings()
+{
+	AlphaBetaSettings settings;
+	settings.nullMovePruning = true;
+	settings.lateMoveReductions = true;
+	settings.reverseFutilityPruning = true;
+	settings.futilityPruning = true;
+	settings.checkExtensions = true;
+	return settings;
+}
+
+TEST(AlphaBetaSearchTest, SelectiveSearchFindsMate)
+{
+	const Board board = Board::buildFromFEN("2r4k/6pp/5p2/7K/2R1r3/q4n2/2R5/8 w - - 0 1");
+	const SearchResult result = AlphaBetaSearch(nullptr, 0u, selectiveSettings()).searchDepth(board, 8u);
+	EXPECT_EQ(result.bestMove.asUCIstr(), "c4c8");
+	EXPECT_EQ(result.score, AlphaBetaSearch::MATE_SCORE - 5);
+}
+
+TEST(AlphaBetaSearchTest, SelectiveSearchSavesNodes)
+{
+	const Board board = Board::buildFromFEN("r3k2r/pp1n1ppp/2pbpn2/q7/3P4/2NBPN2/PP3PPP/R2QK2R w KQkq - 0 10");
+	const SearchResult plain = AlphaBetaSearch().searchDepth(board, 5u);
+	AlphaBetaSettings nullMove;
+	nullMove.nullMovePruning = true;
+	AlphaBetaSettings reductions;
+	reductions.lateMoveReductions = true;
+	AlphaBetaSettings reverseFutility;
+	reverseFutility.reverseFutilityPruning = true;
+	AlphaBetaSettings futility;
+	futility.futilityPruning = true;
+	for (const AlphaBetaSettings& settings : { nullMove, reductions, reverseFutility, futility, selectiveSettings() })
+	{
+		const SearchResult selective = AlphaBetaSearch(nullptr, 0u, settings).searchDepth(board, 5u);
+		EXPECT_LT(selective.nodes, plain.nodes);
+		EXPECT_EQ(selective.depth, 5u);
+	}
+}
+
+TEST(AlphaBetaSearchTest, NoNullMoveWithOnlyPawns)
+{
+	// Passing could be better than any real move in a pawn ending, so the null move search is never tried.
+	const Board board = Board::buildFromFEN("8/5k2/8/3p4/3P4/8/5K2/8 w - - 0 1");
+	AlphaBetaSettings nullMove;
+	nullMove.nullMovePruning = true;
+	const SearchResult plain = AlphaBetaSearch().searchDepth(board, 6u);
+	const SearchResult pruned = AlphaBetaSearch(nullptr, 0u, nullMove).searchDepth(board, 6u);
+	EXPECT_EQ(pruned.nodes, plain.nodes);
+	EXPECT_EQ(pruned.score, plain.score);
+}
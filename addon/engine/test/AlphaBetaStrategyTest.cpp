@@ -0,0 +1,22 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../src/AlphaBetaStrategy/AlphaBetaStrategy.h"
+#include "../src/Board.h"
+
+TEST(AlphaBetaStrategyTest, MeasuresTimeToDepth)
+{
+	const Board board = Board::buildFromFEN("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+	for (unsigned int threads : { 1u, 2u })
+	{
+		// The main search completes every depth, the helpers skip some of them.
+		const std::vector<float> seconds = AlphaBetaStrategy::measureTimeToDepth(board, 4u, threads);
+		ASSERT_EQ(seconds.size(), 4u);
+		for (size_t i = 1u; i < seconds.size(); i++)
+		{
+			EXPECT_GE(seconds[i], seconds[i - 1u]);
+		}
+		EXPECT_GT(seconds.back(), 0.0f);
+	}
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include "../src/Board.h"
+#include "../src/BoardEvaluator.h"
+
+TEST(BoardEvaluatorTest, MaterialBalance)
+{
+	EXPECT_FLOAT_EQ(BoardEvaluator::evaluateBoard(Board()), 0.0f);
+	EXPECT_FLOAT_EQ(BoardEvaluator::evaluateBoard(Board::buildFromFEN("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1")), -4.0f);
+}
+
+TEST(BoardEvaluatorTest, QuiescentTakesHangingPiece)
+{
+	// The rook on d5 is free for the queen.
+	const Board board = Board::buildFromFEN("4k3/8/8/3r4/8/8/3Q4/7K w - - 0 1");
+	EXPECT_FLOAT_EQ(BoardEvaluator::evaluateQuiescent(board, 4u), 9.0f);
+	// From black's turn the rook simply takes the queen.
+	const Board blackToMove = Board::buildFromFEN("4k3/8/8/3r4/8/8/3Q4/7K b - - 0 1");
+	EXPECT_FLOAT_EQ(BoardEvaluator::evaluateQuiescent(blackToMove, 4u), -5.0f);
+}
+
+TEST(BoardEvaluatorTest, QuiescentAvoidsLosingCaptures)
+{
+	// Taking the defended pawn would lose the queen, so white stands pat.
+	const Board board = Board::buildFromFEN("4k3/2p5/3p4/8/8/8/3Q4/4K3 w - - 0 1");
+	EXPECT_FLOAT_EQ(BoardEvaluator::evaluateQuiescent(board, 4u), 7.0f);
+	// Without depth the material is counted as it stands.
+	EXPECT_FLOAT_EQ(BoardEvaluator::evaluateQuiescent(board, 0u), 7.0f);
+}
+
+TEST(BoardEvaluatorTest, QuiescentSearchesEvasions)
+{
+	// Taking the rook mates on the back rank, which is only seen by searching black's evasions.
+	// Black is mated one ply from the start.
+	const Board board = Board::buildFromFEN("4r2k/6pp/8/8/8/8/8/4R1K1 w - - 0 1");
+	EXPECT_FLOAT_EQ(BoardEvaluator::evaluateQuiescent(board, 4u), -BoardEvaluator::MATED - 1.0f);
+}
+
+TEST(BoardEvaluatorTest, QuiescentDeltaPruning)
+{
+	// Winning a pawn can't bring the score anywhere near the window, so no capture is searched.
+	const Board board = Board::buildFromFEN("4k3/8/8/3p4/8/8/3R4/4K3 w - - 0 1");
+	uint64_t nodes = 0u;
+	EXPECT_FLOAT_EQ(BoardEvaluator::searchQuiescent(board, 8.0f, 9.0f, 4u, &nodes), 4.0f);
+	EXPECT_EQ(nodes, 1u);
+	// Inside the window the capture is searched.
+	nodes = 0u;
+	EXPECT_FLOAT_EQ(BoardEvaluator::searchQuiescent(board, 0.0f, 9.0f, 4u, &nodes), 5.0f);
+	EXPECT_GT(nodes, 1u);
+}
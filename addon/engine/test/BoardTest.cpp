@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <iostream>
+#include <map>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -7,6 +9,7 @@
 
 #include "../src/Board.h"
 #include "../src/Move.h"
+#include "../src/Random.h"
 #include "../src/ScopedProfiler.h"
 #include "../src/StringUtil.h"
 
@@ -88,9 +91,9 @@ TEST(BoardTest, HashTest1)
 	board.applyMove(board.constructMove("d7d5"));
 	board.applyMove(board.constructMove("b1c3"));
 	board.applyMove(board.constructMove("g8f6"));
-	unsigned int hash1 = board.getHash();
+	uint64_t hash1 = board.getHash();
 	Board board2 = Board::buildFromFEN("rnbqkb1r/ppp1pppp/5n2/3p4/3P4/2N5/PPP1PPPP/R1BQKBNR w KQkq - 2 3");
-	unsigned int hash2 = board2.getHash();
+	uint64_t hash2 = board2.getHash();
 	ASSERT_EQ(hash1, hash2);
 }
 
@@ -102,20 +105,20 @@ TEST(BoardTest, HashTest2)
 	board.applyMove(board.constructMove("d7d6"));
 	board.applyMove(board.constructMove("b1c3"));
 	board.applyMove(board.constructMove("g8f6"));
-	unsigned int hash1 = board.getHash();
+	uint64_t hash1 = board.getHash();
 	Board board2;
 	board2.applyMove(board2.constructMove("b1c3"));
 	board2.applyMove(board2.constructMove("g8f6"));
 	board2.applyMove(board2.constructMove("d2d3"));
 	board2.applyMove(board2.constructMove("d7d6"));
-	unsigned int hash2 = board2.getHash();
+	uint64_t hash2 = board2.getHash();
 	ASSERT_EQ(hash1, hash2);
 }
 
 TEST(BoardTest, HashTest3)
 {
 	// After two moves from the initial position, there should be 400 different hashes
-	std::unordered_set<unsigned int> hashes;
+	std::unordered_set<uint64_t> hashes;
 	Board board;
 	std::vector<Move> possibleMoves = board.findPossibleMoves();
 	for (const Move& move : possibleMoves)
@@ -127,7 +130,7 @@ TEST(BoardTest, HashTest3)
 		{
 			Board boardCopy2 = boardCopy;
 			boardCopy2.applyMove(move2);
-			unsigned int hash = boardCopy2.getHash();
+			uint64_t hash = boardCopy2.getHash();
 			hashes.insert(hash);
 		}
 	}
@@ -138,12 +141,12 @@ TEST(BoardTest, HashTest4)
 {
 	// Castling rights should be taken into account
 	Board board = Board::buildFromFEN("rnbqk2r/pppppppp/8/8/8/8/PPPPPPPP/RNBQK2R w KQkq - 0 1");
-	unsigned int hashBefore = board.getHash();
+	uint64_t hashBefore = board.getHash();
 	board.applyMove(board.constructMove("e1g1"));
 	board.applyMove(board.constructMove("b8c6"));
 	board.applyMove(board.constructMove("g1e1"));
 	board.applyMove(board.constructMove("c6b8"));
-	unsigned int hashAfter = board.getHash();
+	uint64_t hashAfter = board.getHash();
 	ASSERT_NE(hashBefore, hashAfter);
 }
 
@@ -151,12 +154,12 @@ TEST(BoardTest, HashTest5)
 {
 	// Moving back and forth should not change the hash (unless castling rights are changed)
 	Board board = Board::buildFromFEN("rnbqkb1r/1p2pppp/p2p1n2/8/3NP3/2N5/PPP2PPP/R1BQKB1R w KQkq - 0 6");
-	unsigned int hashBefore = board.getHash();
+	uint64_t hashBefore = board.getHash();
 	board.applyMove(board.constructMove("c1f4"));
 	board.applyMove(board.constructMove("d8d7"));
 	board.applyMove(board.constructMove("f4c1"));
 	board.applyMove(board.constructMove("d7d8"));
-	unsigned int hashAfter = board.getHash();
+	uint64_t hashAfter = board.getHash();
 	ASSERT_EQ(hashBefore, hashAfter);
 }
 
@@ -164,10 +167,10 @@ TEST(BoardTest, HashTest6)
 {
 	// Different player in turn should change the hash
 	Board board = Board::buildFromFEN("rnbqkb1r/1p2pppp/p2p1n2/8/3NP3/2N5/PPP2PPP/R1BQKB1R w KQkq - 0 6");
-	unsigned int hash1 = board.getHash();
+	uint64_t hash1 = board.getHash();
 	Board board2 = Board::buildFromFEN("rnbqkb1r/1p2pppp/p2p1n2/8/3N4/2N1P3/PPP2PPP/R1BQKB1R w KQkq - 0 6");
 	board2.applyMove(board2.constructMove("e3e4"));
-	unsigned int hash2 = board2.getHash();
+	uint64_t hash2 = board2.getHash();
 	ASSERT_NE(hash1, hash2);
 }
 
@@ -179,7 +182,7 @@ TEST(BoardTest, HashTest7)
 	board.applyMove("d7d6");
 	board.applyMove("d4d5");
 	board.applyMove("e7e5");
-	unsigned int enPassantHash = board.getHash();
+	uint64_t enPassantHash = board.getHash();
 	Board board2;
 	// 1. d3 d6 2. d4 e6 3. d5 e5
 	board2.applyMove("d2d3");
@@ -188,7 +191,7 @@ TEST(BoardTest, HashTest7)
 	board2.applyMove("e7e6");
 	board2.applyMove("d4d5");
 	board2.applyMove("e6e5");
-	unsigned int noEnPassantHash = board2.getHash();
+	uint64_t noEnPassantHash = board2.getHash();
 	ASSERT_NE(enPassantHash, noEnPassantHash);
 }
 
@@ -197,9 +200,9 @@ TEST(BoardTest, HashTest8)
 	// Check that taking a piece leads to correct hash
 	Board board = Board::buildFromFEN("r1bqk2r/pp3ppp/2nppn2/2p5/2PP4/2PBPN2/P4PPP/R1BQK2R w KQkq - 0 8");
 	board.applyMove(board.constructMove("d4c5"));
-	unsigned int hash1 = board.getHash();
+	uint64_t hash1 = board.getHash();
 	Board board2 = Board::buildFromFEN("r1bqk2r/pp3ppp/2nppn2/2P5/2P5/2PBPN2/P4PPP/R1BQK2R b KQkq - 0 8");
-	unsigned int hash2 = board2.getHash();
+	uint64_t hash2 = board2.getHash();
 	ASSERT_EQ(hash1, hash2);
 }
 
@@ -208,9 +211,9 @@ TEST(BoardTest, HashTest8_1)
 	// End up to the same position as in the previous test but with different move
 	Board board = Board::buildFromFEN("r1bqk2r/pp3ppp/2nppn2/2P5/2P5/2P1PN2/P1B2PPP/R1BQK2R w KQkq - 0 8");
 	board.applyMove(board.constructMove("c2d3"));
-	unsigned int hash1 = board.getHash();
+	uint64_t hash1 = board.getHash();
 	Board board2 = Board::buildFromFEN("r1bqk2r/pp3ppp/2nppn2/2P5/2P5/2PBPN2/P4PPP/R1BQK2R b KQkq - 0 8");
-	unsigned int hash2 = board2.getHash();
+	uint64_t hash2 = board2.getHash();
 	ASSERT_EQ(hash1, hash2);
 }
 
@@ -219,9 +222,9 @@ TEST(BoardTest, HashTest9)
 	// Promotion with take
 	Board board = Board::buildFromFEN("1r2k2r/2P4p/5q2/p7/6P1/5P2/2R2K2/2R5 w k - 0 1");
 	board.applyMove(board.constructMove("c7b8q"));
-	unsigned int hash1 = board.getHash();
+	uint64_t hash1 = board.getHash();
 	Board board2 = Board::buildFromFEN("1Q2k2r/7p/5q2/p7/6P1/5P2/2R2K2/2R5 b k - 0 1");
-	unsigned int hash2 = board2.getHash();
+	uint64_t hash2 = board2.getHash();
 	ASSERT_EQ(hash1, hash2);
 }
 
@@ -230,9 +233,9 @@ TEST(BoardTest, HashTest10)
 	// Promotion without take
 	Board board = Board::buildFromFEN("4k2r/7p/5q2/8/5QP1/5P2/p1R2K2/2R5 b k - 0 1");
 	board.applyMove(board.constructMove("a2a1n"));
-	unsigned int hash1 = board.getHash();
+	uint64_t hash1 = board.getHash();
 	Board board2 = Board::buildFromFEN("4k2r/7p/5q2/8/5QP1/5P2/2R2K2/n1R5 w k - 0 1");
-	unsigned int hash2 = board2.getHash();
+	uint64_t hash2 = board2.getHash();
 	ASSERT_EQ(hash1, hash2);
 }
 
@@ -242,12 +245,12 @@ TEST(BoardTest, HashTest11)
 	Board board;
 	board.applyMove("e2e4");
 	board.applyMove("e7e5");
-	unsigned int hash1 = board.getHash();
+	uint64_t hash1 = board.getHash();
 	board.applyMove("b1c3");
 	board.applyMove("b8c6");
 	board.applyMove("c3b1");
 	board.applyMove("c6b8");
-	unsigned int hash2 = board.getHash();
+	uint64_t hash2 = board.getHash();
 	ASSERT_EQ(hash1, hash2);
 }
 
@@ -309,6 +312,20 @@ TEST(BoardTest, DetectRepetitionMidGame)
 	ASSERT_TRUE(board.threefoldRepetition());
 }
 
+TEST(BoardTest, DetectCurrentPositionRepeated)
+{
+	Board board;
+	ASSERT_FALSE(board.isRepetition());
+	board.applyMove("g1f3");
+	board.applyMove("g8f6");
+	board.applyMove("f3g1");
+	ASSERT_FALSE(board.isRepetition());
+	board.applyMove("f6g8");
+	ASSERT_TRUE(board.isRepetition());
+	board.applyMove("b1c3");
+	ASSERT_FALSE(board.isRepetition());
+}
+
 TEST(BoardTest, RepetitiveButDifferentPlayer)
 {
 
@@ -329,6 +346,219 @@ TEST(BoardTest, DetectRepetitionAfterFENInit)
 
 }
 
+TEST(BoardTest, DoubleCheckKingCannotRetreatAlongCheckLine)
+{
+	// Queen on e6 and knight on e3 both check the king. Behind the king on the queen's diagonal, h3 is still attacked.
+	const Board board = Board::buildFromFEN("6k1/8/4q3/8/6K1/4n3/8/8 w - - 0 1");
+	std::vector<Move> moves = board.findPossibleMoves();
+	EXPECT_EQ(moves.size(), 6u);
+	for (const Move& move : moves)
+	{
+		EXPECT_NE(move.asUCIstr(), "g4h3");
+		EXPECT_NE(move.asUCIstr(), "g4f5");
+	}
+}
+
+TEST(BoardTest, RandomMoveIsUniformAmongLegalMoves)
+{
+	Random::Seed(37u);
+	struct UniformityCase
+	{
+		const char* fen;
+		// Chi-squared with one degree of freedom less than there are moves stays below this with a probability above 99.9%.
+		double maxChiSquared;
+	};
+	const UniformityCase cases[] = {
+		// Castling on both sides and pinned pieces, 48 moves.
+		{ "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -", 90.0 },
+		// Castling, en passant, promotions with and without a capture, and a pinned bishop, 26 moves.
+		{ "r6k/1P6/8/4Pp2/1b6/8/3B4/4K2R w K f6 0 1", 60.0 },
+	};
+	for (const UniformityCase& uniformityCase : cases)
+	{
+		const Board board = Board::buildFromFEN(uniformityCase.fen);
+		std::map<std::string, int> counts;
+		for (const Move& move : board.findPossibleMoves())
+		{
+			counts[move.asUCIstr()] = 0;
+		}
+		const int samplesPerMove = 1000;
+		const int samples = samplesPerMove * (int)counts.size();
+		for (int i = 0; i < samples; i++)
+		{
+			Move move;
+			ASSERT_TRUE(board.findRandomMove(move));
+			auto count = counts.find(move.asUCIstr());
+			ASSERT_NE(count, counts.end()) << move.asUCIstr();
+			count->second++;
+		}
+		double chiSquared = 0.0;
+		for (const auto& count : counts)
+		{
+			chiSquared += (count.second - samplesPerMove) * (count.second - samplesPerMove) / double(samplesPerMove);
+		}
+		EXPECT_LT(chiSquared, uniformityCase.maxChiSquared) << uniformityCase.fen;
+	}
+}
+
+TEST(BoardTest, RandomMovesFollowLegalMoves)
+{
+	Random::Seed(38u);
+	for (int game = 0; game < 200; game++)
+	{
+		Board board;
+		for (int ply = 0; ply < 200; ply++)
+		{
+			std::vector<Move> legalMoves = board.findPossibleMoves();
+			Move move;
+			bool found = board.findRandomMove(move);
+			ASSERT_EQ(found, legalMoves.size() > 0u);
+			if (!found || board.insufficientMaterial())
+				break;
+			ASSERT_TRUE(std::any_of(legalMoves.begin(), legalMoves.end(), [&move](Move& legalMove) {
+				return legalMove == move;
+			})) << move.asUCIstr();
+			board.applyMove(move);
+		}
+	}
+}
+
+TEST(BoardTest, RandomMoveOnMateAndStalemate)
+{
+	Move move;
+	EXPECT_FALSE(Board::buildFromFEN("3q3k/5KQ1/5N2/8/8/5r2/8/8 b - - 0 1").findRandomMove(move));
+	EXPECT_FALSE(Board::buildFromFEN("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1").findRandomMove(move));
+	// Only the pinned rook can't move sideways.
+	const Board pinned = Board::buildFromFEN("k7/8/8/8/8/8/r7/R3K3 b - - 0 1");
+	for (int i = 0; i < 200; i++)
+	{
+		ASSERT_TRUE(pinned.findRandomMove(move));
+		if (move.from[0] == 8)
+		{
+			EXPECT_EQ(move.to[0] % 8, 0) << move.asUCIstr();
+		}
+	}
+}
+
+TEST(BoardTest, CapturedPiece)
+{
+	const Board board = Board::buildFromFEN("r3k3/8/8/3pP3/8/8/8/R3K2R w KQq d6 0 1");
+	EXPECT_EQ(board.capturedPiece(board.constructMove("a1a8")), Piece::ROOK | Piece::BLACK);
+	EXPECT_EQ(board.capturedPiece(board.constructMove("e5d6")), Piece::PAWN | Piece::BLACK);
+	EXPECT_EQ(board.capturedPiece(board.constructMove("e1g1")), Piece::NONE);
+	EXPECT_EQ(board.capturedPiece(board.constructMove("a1a7")), Piece::NONE);
+}
+
+TEST(BoardTest, StaticExchangeEvaluation)
+{
+	// The rook on d5 is free.
+	const Board hanging = Board::buildFromFEN("4k3/8/8/3r4/8/8/3Q4/7K w - - 0 1");
+	EXPECT_FLOAT_EQ(hanging.see(hanging.constructMove("d2d5")), 5.0f);
+	// The pawn is defended by a pawn.
+	const Board defended = Board::buildFromFEN("4k3/2p5/3p4/8/8/8/3Q4/4K3 w - - 0 1");
+	EXPECT_FLOAT_EQ(defended.see(defended.constructMove("d2d6")), -8.0f);
+	// The second rook behind the first one takes back, found once the first one has left the file.
+	const Board xray = Board::buildFromFEN("4r1k1/8/8/4p3/8/8/4R3/4R1K1 w - - 0 1");
+	EXPECT_FLOAT_EQ(xray.see(xray.constructMove("e2e5")), 1.0f);
+	// Black stops after the first recapture when the bishop behind the queen would only lose more.
+	const Board stop = Board::buildFromFEN("6k1/8/2q5/3n4/8/8/8/1B1RK3 b - - 0 1");
+	EXPECT_FLOAT_EQ(stop.see(stop.constructMove("d5c3")), 0.0f);
+	// A king can take an undefended piece, but not a defended one.
+	const Board king = Board::buildFromFEN("4k3/8/8/b7/8/8/3p4/4K3 w - - 0 1");
+	EXPECT_LT(king.see(king.constructMove("e1d2")), 0.0f);
+	const Board freeForKing = Board::buildFromFEN("4k3/8/8/8/8/8/3p4/4K3 w - - 0 1");
+	EXPECT_FLOAT_EQ(freeForKing.see(freeForKing.constructMove("e1d2")), 1.0f);
+	// En passant takes the pawn beside the target square.
+	const Board enPassant = Board::buildFromFEN("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1");
+	EXPECT_FLOAT_EQ(enPassant.see(enPassant.constructMove("e5d6")), 1.0f);
+	// A quiet move onto a defended square gives the piece away.
+	EXPECT_FLOAT_EQ(hanging.see(hanging.constructMove("d2b4")), 0.0f);
+	EXPECT_FLOAT_EQ(hanging.see(hanging.constructMove("d2d4")), -9.0f);
+}
+
+TEST(BoardTest, StaticExchangeThreshold)
+{
+	const char* fens[] = {
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+		"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+		"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+	};
+	const float thresholds[] = { -5.0f, -1.0f, 0.0f, 1.0f, 3.0f };
+	for (const char* fen : fens)
+	{
+		const Board board = Board::buildFromFEN(fen);
+		for (const Move& move : board.findPossibleMoves())
+		{
+			const float see = board.see(move);
+			for (float threshold : thresholds)
+			{
+				EXPECT_EQ(board.seeGE(move, threshold), see >= threshold) << move.asUCIstr();
+			}
+		}
+	}
+}
+
+TEST(BoardTest, NullMove)
+{
+	// Passing the turn gives up the en passant capture, the position is the same as the one with the other player in turn.
+	Board board = Board::buildFromFEN("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1");
+	board.applyNullMove();
+	const Board passed = Board::buildFromFEN("4k3/8/8/3pP3/8/8/8/4K3 b - - 0 1");
+	EXPECT_EQ(board.getCurrentPlayer(), Color::BLACK);
+	EXPECT_EQ(board.getHash(), passed.getHash());
+	EXPECT_EQ(board.findPossibleMoves().size(), passed.findPossibleMoves().size());
+	board.applyNullMove();
+	EXPECT_EQ(board.getCurrentPlayer(), Color::WHITE);
+	EXPECT_EQ(board.getHash(), Board::buildFromFEN("4k3/8/8/3pP3/8/8/8/4K3 w - - 0 1").getHash());
+}
+
+// Compares the captures of the position and the positions after it to the legal moves filtered down to captures.
+void expectCaptureMovesMatch(const Board& board, unsigned int depth)
+{
+	std::vector<Move> legalMoves;
+	board.findPossibleMoves(legalMoves);
+	std::vector<std::string> expected;
+	for (const Move& move : legalMoves)
+	{
+		const bool underPromotion = move.isPromotion() && move.promotion != Piece::QUEEN;
+		if (!underPromotion && (board.capturedPiece(move) != Piece::NONE || move.isPromotion()))
+			expected.push_back(move.asUCIstr());
+	}
+	std::vector<Move> captures;
+	board.findCaptureMoves(captures);
+	std::vector<std::string> found;
+	for (const Move& move : captures)
+	{
+		found.push_back(move.asUCIstr());
+	}
+	std::sort(expected.begin(), expected.end());
+	std::sort(found.begin(), found.end());
+	ASSERT_EQ(found, expected);
+
+	if (depth == 0u)
+		return;
+	for (const Move& move : legalMoves)
+	{
+		Board next = board;
+		next.applyMove(move);
+		expectCaptureMovesMatch(next, depth - 1u);
+	}
+}
+
+TEST(BoardTest, CaptureMoves)
+{
+	const char* fens[] = {
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+		"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+		"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+		"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+	};
+	for (const char* fen : fens)
+	{
+		expectCaptureMovesMatch(Board::buildFromFEN(fen), 2u);
+	}
+}
+
 // https://www.chessprogramming.org/Perft_Results
 TEST(BoardTest, LegalMoves1) 
 {
@@ -1,9 +1,15 @@
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 #include <gtest/gtest.h>
 
 #include "../src/Board.h"
+#include "../src/MonteCarloStrategy/LeafPlayoutWorkers.h"
+#include "../src/MonteCarloStrategy/MonteCarloMemoryBudget.h"
 #include "../src/MonteCarloStrategy/MonteCarloNode.h"
+#include "../src/MonteCarloStrategy/MonteCarloTranspositionTable.h"
+#include "../src/MonteCarloStrategy/UCBKernel.h"
 
 TEST(MonteCarloNodeTest, FreshNode) 
 {	
@@ -38,6 +44,31 @@ TEST(MonteCarloNodeTest, ManyIterations)
     EXPECT_EQ(root.nodeVisits(), iterations);
 }
 
+TEST(MonteCarloNodeTest, BatchedLeafPlayouts)
+{
+    for (bool parallel : { false, true })
+    {
+        MonteCarloNode root;
+        Board board;
+        MonteCarloSettings settings;
+        settings.leafPlayouts = 4u;
+        settings.parallelLeafPlayouts = parallel;
+        LeafPlayoutWorkers workers(3u);
+        if (parallel)
+            settings.playoutWorkers = &workers;
+        for (unsigned int i = 0u; i < 100u; i++)
+        {
+            root.runIteration(board, settings);
+        }
+        // Every iteration is backed up with the weight of all its playouts.
+        EXPECT_EQ(root.nodeVisits(), 400u);
+        for (const MoveStatistics& stats : root.getMoveStatistics())
+        {
+            EXPECT_EQ(stats.visits % 4u, 0u);
+        }
+    }
+}
+
 TEST(MonteCarloNodeTest, ForcedMate1)
 {
     MonteCarloNode root;
@@ -62,4 +93,343 @@ TEST(MonteCarloNodeTest, ForcedMate2)
     }
     const Move bestMove = root.highestWinrateMove();
     EXPECT_EQ(bestMove.asUCIstr(),"c4c8");
-}
\ No newline at end of file
+}
+
+TEST(MonteCarloNodeTest, SolverProvesForcedMate2)
+{
+    MonteCarloNode root;
+    Board forcedMateInTwo = Board::buildFromFEN("2r4k/6pp/5p2/7K/2R1r3/q4n2/2R5/8 w - - 0 1");
+    // The search stops visiting proven lines, once the root is proven it has nothing left to do.
+    for (unsigned int i = 0u; i < 20000u && root.provenResult() == ProvenResult::UNKNOWN; i++)
+    {
+        root.runIteration(forcedMateInTwo, 50u);
+    }
+    EXPECT_EQ(root.provenResult(), ProvenResult::WIN);
+    EXPECT_EQ(root.highestWinrateMove().asUCIstr(), "c4c8");
+}
+
+TEST(MonteCarloNodeTest, MoveStatisticsRoundTrip)
+{
+    MonteCarloNode root;
+    Board board;
+    for (unsigned int i = 0u; i < 100u; i++)
+    {
+        root.runIteration(board, 10u);
+    }
+    std::vector<MoveStatistics> moveStats = root.getMoveStatistics();
+    EXPECT_EQ(moveStats.size(), 20u);
+
+    unsigned int totalVisits = 0u;
+    for (MoveStatistics& stats : moveStats)
+    {
+        EXPECT_LE(stats.points, float(stats.visits));
+        totalVisits += stats.visits;
+        stats.visits *= 2u;
+        stats.points *= 2.0f;
+    }
+    EXPECT_EQ(totalVisits, 100u);
+
+    root.setMoveStatistics(moveStats);
+    EXPECT_EQ(root.nodeVisits(), 200u);
+    std::vector<MoveStatistics> doubledStats = root.getMoveStatistics();
+    for (size_t i = 0; i < doubledStats.size(); i++)
+    {
+        EXPECT_EQ(doubledStats[i].visits, moveStats[i].visits);
+        EXPECT_FLOAT_EQ(doubledStats[i].points, moveStats[i].points);
+    }
+}
+
+
+TEST(MonteCarloNodeTest, TranspositionsShareNodes)
+{
+    MonteCarloTranspositionTable transpositions;
+    MonteCarloSettings settings;
+    settings.transpositions = &transpositions;
+
+    // Both move orders lead to the same position and thus to the same node.
+    Board board1;
+    board1.applyMove("g1f3");
+    board1.applyMove("g8f6");
+    board1.applyMove("b1c3");
+    Board board2;
+    board2.applyMove("b1c3");
+    board2.applyMove("g8f6");
+    board2.applyMove("g1f3");
+    EXPECT_EQ(transpositions.findOrCreate(board1.getHash()), transpositions.findOrCreate(board2.getHash()));
+
+    MonteCarloNode root;
+    Board board;
+    for (unsigned int i = 0u; i < 1000u; i++)
+    {
+        root.runIteration(board, settings);
+    }
+    EXPECT_EQ(root.nodeVisits(), 1000u);
+    EXPECT_GT(transpositions.size(), 20u);
+
+    // After moving on, the nodes of the other moves are forgotten.
+    const size_t nodesBefore = transpositions.size();
+    MonteCarloNode nextRoot = root.getNodeForMove(root.highestWinrateMove());
+    transpositions.collectGarbage(nextRoot);
+    EXPECT_LT(transpositions.size(), nodesBefore);
+}
+
+TEST(MonteCarloNodeTest, TranspositionCyclesDontReenterNodes)
+{
+    MonteCarloTranspositionTable transpositions;
+    MonteCarloSettings settings;
+    settings.transpositions = &transpositions;
+    // The pawns are blocked, so only the kings move and the positions soon repeat through cycles in the graph.
+    const Board board = Board::buildFromFEN("k7/8/8/p7/P7/8/8/7K w - - 0 1");
+    std::vector<std::shared_ptr<MonteCarloNode>> rootChildren;
+    for (const char* move : { "h1g1", "h1g2", "h1h2" })
+    {
+        Board child = board;
+        child.applyMove(move);
+        rootChildren.push_back(transpositions.findOrCreate(child.getHash()));
+    }
+
+    MonteCarloNode root;
+    std::vector<unsigned int> childVisits(rootChildren.size(), 0u);
+    for (unsigned int i = 0u; i < 2000u; i++)
+    {
+        root.runIteration(board, settings);
+        // Other move orders may reach a child of the root through a transposition, but no iteration enters a node twice,
+        // even when a cycle leads back to it.
+        unsigned int enteredChildren = 0u;
+        for (size_t j = 0u; j < rootChildren.size(); j++)
+        {
+            const unsigned int visits = rootChildren[j]->nodeVisits();
+            ASSERT_LE(visits, childVisits[j] + 1u) << "iteration " << i;
+            enteredChildren += visits - childVisits[j];
+            childVisits[j] = visits;
+        }
+        ASSERT_GE(enteredChildren, 1u);
+    }
+}
+
+TEST(MonteCarloNodeTest, ForcedMate1WithTranspositions)
+{
+    MonteCarloTranspositionTable transpositions;
+    MonteCarloSettings settings;
+    settings.maxMoveCount = 50u;
+    settings.transpositions = &transpositions;
+    MonteCarloNode root;
+    Board forcedMateInOne = Board::buildFromFEN("3q3k/5K2/5NP1/8/8/5r2/8/8 w - - 0 1");
+    for (unsigned int i = 0u; i < 1000u; i++)
+    {
+        root.runIteration(forcedMateInOne, settings);
+    }
+    EXPECT_EQ(root.highestWinrateMove().asUCIstr(), "g6g7");
+}
+
+TEST(MonteCarloNodeTest, UCBKernelMatchesScalarUCB1)
+{
+    // Odd child count so both the vector loop and the scalar tail are used.
+    const int childCount = 37;
+    unsigned int visits[childCount];
+    float points[childCount];
+    for (int i = 0; i < childCount; i++)
+    {
+        // Some visit counts are past the end of the inverse square root table.
+        visits[i] = i % 5 == 0 ? 0u : i % 6 == 0 ? 4000u + 20u * i : (unsigned int)(i * 13 % 97);
+        points[i] = visits[i] * (i % 7) / 7.0f;
+    }
+    const float scale = UCBKernel::explorationScale(2000u);
+    EXPECT_NEAR(scale, 2.0f * std::sqrt(std::log(2000.0f)), 1e-6f);
+    float scores[UCBKernel::MAX_CHILDREN];
+    float best = UCBKernel::scoreChildren(visits, points, childCount, scale, scores);
+
+    float expectedBest = -FLT_MAX;
+    for (int i = 0; i < childCount; i++)
+    {
+        float expected = visits[i] == 0u ? FLT_MAX : 1.0f - points[i] / visits[i] + scale / std::sqrt(float(visits[i]));
+        EXPECT_NEAR(scores[i], expected, 1e-5f);
+        expectedBest = std::max(expectedBest, scores[i]);
+    }
+    EXPECT_EQ(best, expectedBest);
+    EXPECT_NEAR(UCBKernel::inverseSqrt(10000u), 0.01f, 1e-6f);
+}
+
+TEST(MonteCarloNodeTest, ChildrenCreatedOnFirstVisit)
+{
+    MonteCarloNode root;
+    Board board;
+    root.runIteration(board);
+    // The first iteration expands the root and visits one of its children,
+    // the unvisited children are picked next and don't have a node yet.
+    Move bestMove;
+    EXPECT_EQ(root.highestUCB1Child(&bestMove), nullptr);
+
+    unsigned int visitedChildren = 0u;
+    for (const MoveStatistics& stats : root.getMoveStatistics())
+    {
+        visitedChildren += stats.visits > 0u ? 1u : 0u;
+    }
+    EXPECT_EQ(visitedChildren, 1u);
+}
+
+TEST(MonteCarloNodeTest, ProgressiveWideningPrefersCaptures)
+{
+    MonteCarloNode root;
+    // White can take the queen on d5 with the pawn, the knight or the rook.
+    Board board = Board::buildFromFEN("4k3/8/8/3q4/4P3/2N5/8/3RK3 w - - 0 1");
+    MonteCarloSettings settings;
+    settings.wideningConstant = 1.0f;
+    settings.wideningExponent = 0.25f;
+    for (int i = 0; i < 16; i++)
+    {
+        root.runIteration(board, settings);
+    }
+
+    // 16 visits only let the first two moves in, which must be the cheapest captures of the queen.
+    std::vector<std::string> visitedMoves;
+    for (const MoveStatistics& stats : root.getMoveStatistics())
+    {
+        if (stats.visits > 0u)
+            visitedMoves.push_back(stats.move.asUCIstr());
+    }
+    ASSERT_EQ(visitedMoves.size(), 2u);
+    EXPECT_EQ(visitedMoves[0], "e4d5");
+    EXPECT_EQ(visitedMoves[1], "c3d5");
+}
+
+TEST(MonteCarloNodeTest, MemoryBudgetStopsGrowth)
+{
+    MonteCarloNode root;
+    Board board;
+    MonteCarloMemoryBudget budget(50u);
+    MonteCarloSettings settings;
+    settings.memoryBudget = &budget;
+    for (int i = 0; i < 1000; i++)
+    {
+        root.runIteration(board, settings);
+    }
+    EXPECT_EQ(root.nodeVisits(), 1000u);
+    EXPECT_TRUE(budget.isFull());
+
+    size_t nodeCount, byteCount;
+    root.measureTree(nodeCount, byteCount);
+    // The budget doesn't count the root.
+    EXPECT_EQ(nodeCount, 51u);
+    EXPECT_EQ(budget.usedNodes(), 50u);
+    EXPECT_GT(byteCount, 0u);
+}
+
+TEST(MonteCarloNodeTest, PruneSubtreesKeepsRootStatistics)
+{
+    MonteCarloNode root;
+    Board board;
+    for (int i = 0; i < 500; i++)
+    {
+        root.runIteration(board);
+    }
+    const std::vector<MoveStatistics> statsBefore = root.getMoveStatistics();
+    size_t nodesBefore, bytesBefore;
+    root.measureTree(nodesBefore, bytesBefore);
+
+    root.pruneSubtrees(std::numeric_limits<unsigned int>::max());
+    size_t nodesAfter, bytesAfter;
+    root.measureTree(nodesAfter, bytesAfter);
+    // Only the root and its children are left.
+    EXPECT_EQ(nodesAfter, 1u + statsBefore.size());
+    EXPECT_LT(nodesAfter, nodesBefore);
+    EXPECT_LT(bytesAfter, bytesBefore);
+
+    const std::vector<MoveStatistics> statsAfter = root.getMoveStatistics();
+    ASSERT_EQ(statsAfter.size(), statsBefore.size());
+    for (size_t i = 0u; i < statsBefore.size(); i++)
+    {
+        EXPECT_EQ(statsAfter[i].visits, statsBefore[i].visits);
+        EXPECT_EQ(statsAfter[i].points, statsBefore[i].points);
+    }
+
+    // The search goes on from the pruned tree.
+    root.runIteration(board);
+    EXPECT_EQ(root.nodeVisits(), 501u);
+}
+
+TEST(MonteCarloNodeTest, CompactNodesRegenerateMoves)
+{
+    MonteCarloSettings compactSettings;
+    compactSettings.maxMoveCount = 50u;
+    compactSettings.keepMovesDepth = 1u;
+    MonteCarloNode mateRoot;
+    Board forcedMateInOne = Board::buildFromFEN("3q3k/5K2/5NP1/8/8/5r2/8/8 w - - 0 1");
+    for (unsigned int i = 0u; i < 1000u; i++)
+    {
+        mateRoot.runIteration(forcedMateInOne, compactSettings);
+    }
+    EXPECT_EQ(mateRoot.highestWinrateMove().asUCIstr(), "g6g7");
+
+    MonteCarloNode root;
+    MonteCarloNode compactRoot;
+    Board board;
+    for (unsigned int i = 0u; i < 1000u; i++)
+    {
+        root.runIteration(board, 50u);
+        compactRoot.runIteration(board, compactSettings);
+    }
+    size_t nodeCount, byteCount, compactNodeCount, compactByteCount;
+    root.measureTree(nodeCount, byteCount);
+    compactRoot.measureTree(compactNodeCount, compactByteCount);
+    EXPECT_LT(compactByteCount / compactNodeCount, byteCount / nodeCount);
+
+    // A child of the root keeps its moves and can become the next root.
+    MonteCarloNode nextRoot = compactRoot.getNodeForMove(compactRoot.highestWinrateMove());
+    EXPECT_EQ(nextRoot.getMoveStatistics().size(), 20u);
+}
+
+TEST(MonteCarloNodeTest, EvaluatedLeavesWithMinimaxBackups)
+{
+    MonteCarloSettings evaluationSettings;
+    evaluationSettings.evaluateLeaves = true;
+    evaluationSettings.minimaxWeight = 0.5f;
+    // The rook on a5 is free, while the pawn on d6 is defended and taking it loses the queen.
+    Board board = Board::buildFromFEN("4k3/2p5/3p4/r7/8/8/3Q4/7K w - - 0 1");
+    MonteCarloNode root;
+    for (unsigned int i = 0u; i < 2000u; i++)
+    {
+        root.runIteration(board, evaluationSettings);
+    }
+    EXPECT_EQ(root.highestWinrateMove(evaluationSettings.minimaxWeight).asUCIstr(), "d2a5");
+
+    // Resolving the captures at the leaves finds the same move.
+    evaluationSettings.resolveCapturesDepth = 4u;
+    MonteCarloNode resolvedRoot;
+    for (unsigned int i = 0u; i < 2000u; i++)
+    {
+        resolvedRoot.runIteration(board, evaluationSettings);
+    }
+    EXPECT_EQ(resolvedRoot.highestWinrateMove(evaluationSettings.minimaxWeight).asUCIstr(), "d2a5");
+}
+
+TEST(MonteCarloNodeTest, RaveStatistics)
+{
+    MonteCarloSettings raveSettings;
+    raveSettings.maxMoveCount = 50u;
+    raveSettings.raveEquivalence = 500.0f;
+    MonteCarloNode mateRoot;
+    Board forcedMateInOne = Board::buildFromFEN("3q3k/5K2/5NP1/8/8/5r2/8/8 w - - 0 1");
+    for (unsigned int i = 0u; i < 1000u; i++)
+    {
+        mateRoot.runIteration(forcedMateInOne, raveSettings);
+    }
+    EXPECT_EQ(mateRoot.highestWinrateMove().asUCIstr(), "g6g7");
+
+    // The counters add a few bytes per child, compared to the same tree without them.
+    MonteCarloNode root;
+    MonteCarloNode raveRoot;
+    Board board;
+    MonteCarloSettings settings;
+    settings.maxMoveCount = 50u;
+    for (unsigned int i = 0u; i < 1000u; i++)
+    {
+        root.runIteration(board, settings);
+        raveRoot.runIteration(board, raveSettings);
+    }
+    size_t nodeCount, byteCount, raveNodeCount, raveByteCount;
+    root.measureTree(nodeCount, byteCount);
+    raveRoot.measureTree(raveNodeCount, raveByteCount);
+    EXPECT_GT(raveByteCount / raveNodeCount, byteCount / nodeCount);
+    EXPECT_LT(raveByteCount / raveNodeCount, byteCount / nodeCount * 3 / 2);
+}
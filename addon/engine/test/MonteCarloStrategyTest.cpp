@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+
+#include "../src/MonteCarloStrategy/MonteCarloStrategy.h"
+
+// Exposes the ticks, which end by enforcing the memory budget.
+class BudgetedMonteCarloStrategy : public MonteCarloStrategy
+{
+public:
+	using MonteCarloStrategy::MonteCarloStrategy;
+
+	void tick()
+	{
+		tickComputation();
+	}
+};
+
+TEST(MonteCarloStrategyTest, PrunesTreeToMemoryBudget)
+{
+	const size_t maxNodes = 500u;
+	BudgetedMonteCarloStrategy strategy(MonteCarloSettings{ .maxMoveCount = 10u }, false, maxNodes);
+	size_t previousNodes = 0u;
+	bool pruned = false;
+	for (int tick = 0; tick < 1000 && !pruned; tick++)
+	{
+		strategy.tick();
+		size_t nodes, bytes;
+		strategy.measureTree(nodes, bytes);
+		// A tick leaving the tree at 90% of the budget or more prunes it down to half.
+		EXPECT_LT(nodes, maxNodes * 9u / 10u);
+		pruned = nodes < previousNodes;
+		if (pruned)
+		{
+			EXPECT_LT(nodes, maxNodes / 2u);
+		}
+		previousNodes = nodes;
+	}
+	EXPECT_TRUE(pruned);
+}
@@ -0,0 +1,58 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../src/AlphaBetaStrategy/MovePicker.h"
+#include "../src/AlphaBetaStrategy/TranspositionTable.h"
+#include "../src/Board.h"
+
+TEST(MovePickerTest, PicksInStages)
+{
+	// The rook on g7 is free, the pawn on d5 is an even trade and the knight on b5 costs the queen.
+	const Board board = Board::buildFromFEN("4k3/6r1/2p5/1n1p4/4P3/8/1Q6/R3K3 w - - 0 1");
+	MoveOrdering ordering;
+	const Move previous = Move(52, 44);
+	ordering.updateQuietCutoff(Color::WHITE, 3, 4, board.constructMove("e1f1"), Move(), nullptr, 0);
+	const Move failed = board.constructMove("b2b3");
+	ordering.updateQuietCutoff(Color::WHITE, 3, 4, board.constructMove("e1d2"), Move(), &failed, 1);
+	ordering.updateQuietCutoff(Color::WHITE, 5, 2, board.constructMove("a1b1"), previous, nullptr, 0);
+
+	std::vector<Move> moves = board.findPossibleMoves();
+	const size_t moveCount = moves.size();
+	MovePicker picker(board, moves, TranspositionTable::packMove(board.constructMove("a1a2")), ordering, 3, previous);
+	std::vector<std::string> picked;
+	Move move;
+	while (picker.next(move))
+	{
+		picked.push_back(move.asUCIstr());
+	}
+	ASSERT_EQ(picked.size(), moveCount);
+
+	const std::vector<std::string> first = { "a1a2", "b2g7", "e4d5", "e1d2", "e1f1", "a1b1" };
+	for (size_t i = 0u; i < first.size(); i++)
+	{
+		EXPECT_EQ(picked[i], first[i]);
+	}
+	// The quiet move that failed before a cutoff comes after the unknown ones, the losing capture after all.
+	EXPECT_EQ(picked[moveCount - 2u], "b2b3");
+	EXPECT_EQ(picked[moveCount - 1u], "b2b5");
+}
+
+TEST(MovePickerTest, HistoryStaysBounded)
+{
+	MoveOrdering ordering;
+	const Move move(12, 28);
+	for (int i = 0; i < 10000; i++)
+	{
+		ordering.updateQuietCutoff(Color::BLACK, 0, 40, move, Move(), nullptr, 0);
+	}
+	EXPECT_GT(ordering.history(Color::BLACK, move), 0);
+	EXPECT_LE(ordering.history(Color::BLACK, move), 16384);
+	EXPECT_EQ(ordering.history(Color::WHITE, move), 0);
+	// A new search halves the history and forgets the killers.
+	const int history = ordering.history(Color::BLACK, move);
+	ordering.newSearch();
+	EXPECT_EQ(ordering.history(Color::BLACK, move), history / 2);
+	EXPECT_EQ(ordering.killer(0, 0), 0u);
+}
@@ -0,0 +1,84 @@
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+#include <gtest/gtest.h>
+
+#include "../src/Board.h"
+#include "../src/MonteCarloStrategy/MonteCarloNode.h"
+#include "../src/MonteCarloStrategy/MovePrior.h"
+
+TEST(MovePriorTest, PriorsAreADistribution)
+{
+	const Board board;
+	const std::vector<Move> moves = board.findPossibleMoves();
+	std::vector<float> priors;
+	MovePrior().computePriors(board, moves, priors);
+	ASSERT_EQ(priors.size(), moves.size());
+	EXPECT_NEAR(std::accumulate(priors.begin(), priors.end(), 0.0f), 1.0f, 1e-5f);
+	for (float prior : priors)
+	{
+		EXPECT_GT(prior, 0.0f);
+	}
+}
+
+TEST(MovePriorTest, FreeCaptureGetsTheHighestPrior)
+{
+	const Board board = Board::buildFromFEN("4k3/2p5/3p4/r7/8/8/3Q4/7K w - - 0 1");
+	const std::vector<Move> moves = board.findPossibleMoves();
+	std::vector<float> priors;
+	MovePrior().computePriors(board, moves, priors);
+	const size_t bestIdx = std::max_element(priors.begin(), priors.end()) - priors.begin();
+	EXPECT_EQ(moves[bestIdx].asUCIstr(), "d2a5");
+}
+
+TEST(MovePriorTest, LoadWeightsFromFile)
+{
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "MovePriorTestWeights.txt";
+	{
+		std::ofstream file(path);
+		file << "# Only captures matter\n";
+		file << "captureValue 2.5\n";
+		file << "\n";
+		file << "kingMove -3\n";
+	}
+	MovePrior prior;
+	const float checkWeight = prior.getWeight(MovePrior::CHECK);
+	EXPECT_TRUE(prior.loadFromFile(path.string()));
+	EXPECT_FLOAT_EQ(prior.getWeight(MovePrior::CAPTURE_VALUE), 2.5f);
+	EXPECT_FLOAT_EQ(prior.getWeight(MovePrior::KING_MOVE), -3.0f);
+	EXPECT_FLOAT_EQ(prior.getWeight(MovePrior::CHECK), checkWeight);
+
+	// An unknown feature rejects the whole file.
+	{
+		std::ofstream file(path);
+		file << "captureValue 1\n";
+		file << "mobility 1\n";
+	}
+	EXPECT_FALSE(prior.loadFromFile(path.string()));
+	EXPECT_FLOAT_EQ(prior.getWeight(MovePrior::CAPTURE_VALUE), 2.5f);
+	std::filesystem::remove(path);
+	EXPECT_FALSE(prior.loadFromFile(path.string()));
+}
+
+TEST(MovePriorTest, PUCTSelectionFindsCapture)
+{
+	MonteCarloSettings settings;
+	MovePrior prior;
+	settings.movePrior = &prior;
+	const Board board = Board::buildFromFEN("4k3/2p5/3p4/r7/8/8/3Q4/7K w - - 0 1");
+	MonteCarloNode root;
+	for (unsigned int i = 0u; i < 300u; i++)
+	{
+		root.runIteration(board, settings);
+	}
+	// The prior sends most of the iterations to the capture instead of spreading them evenly.
+	unsigned int captureVisits = 0u;
+	for (const MoveStatistics& stats : root.getMoveStatistics())
+	{
+		if (stats.move.asUCIstr() == "d2a5")
+			captureVisits = stats.visits;
+	}
+	EXPECT_GT(captureVisits, 100u);
+	EXPECT_EQ(root.mostVisitedMove().asUCIstr(), "d2a5");
+}
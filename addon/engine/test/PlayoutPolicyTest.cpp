@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include "../src/Board.h"
+#include "../src/BoardFuncs.h"
+#include "../src/Random.h"
+#include "../src/MonteCarloStrategy/PlayoutPolicy.h"
+
+namespace
+{
+	int countMove(const PlayoutPolicy& policy, const Board& board, const Move& expected, int samples)
+	{
+		int count = 0;
+		Move move;
+		for (int i = 0; i < samples; i++)
+		{
+			EXPECT_TRUE(policy.selectMove(board, move));
+			if (move == expected)
+				count++;
+		}
+		return count;
+	}
+}
+
+TEST(PlayoutPolicyTest, PoliciesByName)
+{
+	EXPECT_EQ(PlayoutPolicy::byName("uniform"), &PlayoutPolicy::uniform());
+	EXPECT_NE(PlayoutPolicy::byName("heavy"), nullptr);
+	EXPECT_EQ(PlayoutPolicy::byName("light"), nullptr);
+}
+
+TEST(PlayoutPolicyTest, HeavyPolicyPrefersCaptures)
+{
+	Random::Seed(4u);
+	const Board board = Board::buildFromFEN("4k3/8/8/3q4/8/8/3Q4/4K3 w - - 0 1");
+	const Move capture(BoardFuncs::getSquareIndex("d2"), BoardFuncs::getSquareIndex("d5"));
+	constexpr int samples = 2000;
+	const int uniformCount = countMove(PlayoutPolicy::uniform(), board, capture, samples);
+	const int heavyCount = countMove(*PlayoutPolicy::byName("heavy"), board, capture, samples);
+	EXPECT_GT(heavyCount, 3 * uniformCount);
+	EXPECT_GT(heavyCount, samples / 8);
+}
+
+TEST(PlayoutPolicyTest, HeavyWeights)
+{
+	const Board promotion = Board::buildFromFEN("k7/4P3/8/8/8/8/8/4K3 w - - 0 1");
+	const char from = BoardFuncs::getSquareIndex("e7");
+	const char to = BoardFuncs::getSquareIndex("e8");
+	EXPECT_GT(
+		HeavyPlayoutPolicy::moveWeight(promotion, Move(from, to, Piece::QUEEN), false),
+		HeavyPlayoutPolicy::moveWeight(promotion, Move(from, to, Piece::KNIGHT), false)
+	);
+
+	// Checking with the rook beats a quiet rook move, and saving the attacked rook beats both.
+	const Board rook = Board::buildFromFEN("k7/8/8/8/8/8/1b6/R3K3 w - - 0 1");
+	const char a1 = BoardFuncs::getSquareIndex("a1");
+	const unsigned int quiet = HeavyPlayoutPolicy::moveWeight(rook, Move(a1, BoardFuncs::getSquareIndex("b1")), false);
+	const unsigned int check = HeavyPlayoutPolicy::moveWeight(rook, Move(a1, BoardFuncs::getSquareIndex("a2")), false);
+	const unsigned int escape = HeavyPlayoutPolicy::moveWeight(rook, Move(a1, BoardFuncs::getSquareIndex("d1")), true);
+	EXPECT_GT(check, quiet);
+	EXPECT_GT(escape, quiet);
+}
+
+TEST(PlayoutPolicyTest, NoMovesOnMate)
+{
+	Move move;
+	const Board mate = Board::buildFromFEN("3q3k/5KQ1/5N2/8/8/5r2/8/8 b - - 0 1");
+	EXPECT_FALSE(PlayoutPolicy::uniform().selectMove(mate, move));
+	EXPECT_FALSE(PlayoutPolicy::byName("heavy")->selectMove(mate, move));
+}
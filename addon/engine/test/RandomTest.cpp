@@ -0,0 +1,85 @@
+#include <climits>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../src/Random.h"
+
+TEST(RandomTest, SeedIsReproducible)
+{
+    Random::Seed(12345u);
+    std::vector<uint64_t> first;
+    for (int i = 0; i < 100; i++)
+    {
+        first.push_back(Random::Next());
+    }
+    Random::Seed(12345u);
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ(Random::Next(), first[i]);
+    }
+}
+
+TEST(RandomTest, RangesStayInBounds)
+{
+    Random::Seed(1u);
+    for (int i = 0; i < 10000; i++)
+    {
+        int signedValue = Random::Range(-3, 5);
+        EXPECT_GE(signedValue, -3);
+        EXPECT_LE(signedValue, 5);
+        unsigned int unsignedValue = Random::Range(7u, 9u);
+        EXPECT_GE(unsignedValue, 7u);
+        EXPECT_LE(unsignedValue, 9u);
+        float floatValue = Random::Range(-1.0f, 1.0f);
+        EXPECT_GE(floatValue, -1.0f);
+        EXPECT_LT(floatValue, 1.0f);
+    }
+    EXPECT_EQ(Random::Range(4, 4), 4);
+    EXPECT_EQ(Random::Range(INT_MIN, INT_MIN), INT_MIN);
+    // The full range of 2^32 values must not break the bounded generation.
+    bool differs = false;
+    unsigned int firstValue = Random::Range(0u, UINT_MAX);
+    for (int i = 0; i < 10 && !differs; i++)
+    {
+        differs = Random::Range(0u, UINT_MAX) != firstValue;
+    }
+    EXPECT_TRUE(differs);
+}
+
+TEST(RandomTest, RangeIsUniform)
+{
+    Random::Seed(2u);
+    // A range that doesn't divide 2^32 evenly, as the legal move counts in playouts.
+    constexpr int buckets = 37;
+    constexpr int samples = buckets * 10000;
+    int counts[buckets] = {};
+    for (int i = 0; i < samples; i++)
+    {
+        counts[Random::Range(0, buckets - 1)]++;
+    }
+    // Chi-squared with 36 degrees of freedom stays below 70 with a probability far above 99.9%.
+    double chiSquared = 0.0;
+    const double expected = samples / double(buckets);
+    for (int count : counts)
+    {
+        chiSquared += (count - expected) * (count - expected) / expected;
+    }
+    EXPECT_LT(chiSquared, 70.0);
+}
+
+TEST(RandomTest, ThreadsHaveOwnGenerators)
+{
+    Random::Seed(3u);
+    const uint64_t mainThreadValue = Random::Next();
+    Random::Seed(3u);
+    uint64_t otherThreadValue = 0u;
+    std::thread other([&otherThreadValue]() {
+        otherThreadValue = Random::Next();
+    });
+    other.join();
+    // The other thread isn't affected by the seed of this thread, and this thread's sequence goes on untouched.
+    EXPECT_NE(otherThreadValue, mainThreadValue);
+    EXPECT_EQ(Random::Next(), mainThreadValue);
+}
@@ -0,0 +1,95 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../src/Board.h"
+#include "../src/RootParallelMonteCarloStrategy/RootParallelMonteCarloStrategy.h"
+
+// Exposes the ticks and the move choice of the strategy.
+class TestedRootParallelStrategy : public RootParallelMonteCarloStrategy
+{
+public:
+	using RootParallelMonteCarloStrategy::RootParallelMonteCarloStrategy;
+
+	void setBoard(const Board& position)
+	{
+		board = position;
+	}
+
+	void tick()
+	{
+		tickComputation();
+	}
+
+	Move bestMove()
+	{
+		return getBestMove();
+	}
+};
+
+TEST(RootParallelMonteCarloStrategyTest, MergesAndAveragesRootStatistics)
+{
+	const Board board;
+	const MonteCarloSettings settings{ .maxMoveCount = 10u };
+	std::vector<MonteCarloNode> trees(3u);
+	for (size_t i = 0u; i < trees.size(); i++)
+	{
+		// Different amounts of iterations, so the trees differ.
+		for (unsigned int j = 0u; j < 200u + 100u * i; j++)
+		{
+			trees[i].runIteration(board, settings);
+		}
+	}
+
+	const std::vector<MoveStatistics> merged = RootParallelMonteCarloStrategy::mergeRootStatistics(trees);
+	ASSERT_EQ(merged.size(), 20u);
+	std::vector<unsigned int> visitSums(merged.size(), 0u);
+	std::vector<float> pointSums(merged.size(), 0.0f);
+	for (const MonteCarloNode& tree : trees)
+	{
+		const std::vector<MoveStatistics> treeStats = tree.getMoveStatistics();
+		ASSERT_EQ(treeStats.size(), merged.size());
+		for (size_t i = 0u; i < treeStats.size(); i++)
+		{
+			// The trees of the same position list the moves in the same order.
+			EXPECT_EQ(treeStats[i].move.asUCIstr(), merged[i].move.asUCIstr());
+			visitSums[i] += treeStats[i].visits;
+			pointSums[i] += treeStats[i].points;
+		}
+	}
+	unsigned int totalVisits = 0u;
+	for (size_t i = 0u; i < merged.size(); i++)
+	{
+		EXPECT_EQ(merged[i].visits, visitSums[i]);
+		EXPECT_NEAR(merged[i].points, pointSums[i], 1e-3f);
+		totalVisits += merged[i].visits;
+	}
+	EXPECT_EQ(totalVisits, 200u + 300u + 400u);
+
+	// Every tree gets the same average, which keeps the mean result of each move.
+	const std::vector<MoveStatistics> shared = RootParallelMonteCarloStrategy::averageRootStatistics(merged, 3u);
+	for (MonteCarloNode& tree : trees)
+	{
+		tree.setMoveStatistics(shared);
+		const std::vector<MoveStatistics> treeStats = tree.getMoveStatistics();
+		for (size_t i = 0u; i < treeStats.size(); i++)
+		{
+			EXPECT_EQ(treeStats[i].visits, (visitSums[i] + 2u) / 3u);
+			if (visitSums[i] > 0u)
+			{
+				EXPECT_NEAR(treeStats[i].points / treeStats[i].visits, pointSums[i] / visitSums[i], 1e-4f);
+			}
+		}
+	}
+}
+
+TEST(RootParallelMonteCarloStrategyTest, FindsMateInOne)
+{
+	TestedRootParallelStrategy strategy(MonteCarloSettings{ .maxMoveCount = 50u }, 2u, 2u);
+	strategy.setBoard(Board::buildFromFEN("3q3k/5K2/5NP1/8/8/5r2/8/8 w - - 0 1"));
+	for (int tick = 0; tick < 20; tick++)
+	{
+		strategy.tick();
+	}
+	EXPECT_EQ(strategy.bestMove().asUCIstr(), "g6g7");
+}
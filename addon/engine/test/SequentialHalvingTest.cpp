@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include "../src/Board.h"
+#include "../src/MonteCarloStrategy/MonteCarloNode.h"
+#include "../src/MonteCarloStrategy/SequentialHalving.h"
+
+TEST(SequentialHalvingTest, HalvesByAveragePoints)
+{
+	// Eight moves, the later the better.
+	std::vector<MoveStatistics> stats(8);
+	for (int i = 0; i < 8; i++)
+	{
+		stats[i].move = Move(char(i), char(i + 8));
+	}
+	SequentialHalving halving;
+	halving.start(stats, 240u);
+	// Three rounds of 80 iterations, 10 for each of the eight candidates in the first.
+	std::vector<int> visitsPerMove(8, 0);
+	while (!halving.roundFinished())
+	{
+		const int child = halving.nextChild();
+		visitsPerMove[child]++;
+		stats[child].visits++;
+		stats[child].points += child / 8.0f;
+	}
+	EXPECT_EQ(visitsPerMove, std::vector<int>(8, 10));
+	halving.halve(stats);
+	// Every round has the same budget, so the four remaining candidates get 20 iterations each.
+	EXPECT_EQ(halving.candidateCount(), 4u);
+	for (int i = 0; i < 80; i++)
+	{
+		EXPECT_GE(halving.nextChild(), 4);
+	}
+	EXPECT_TRUE(halving.roundFinished());
+	halving.halve(stats);
+	halving.halve(stats);
+	EXPECT_EQ(halving.candidateCount(), 1u);
+	EXPECT_FALSE(halving.roundFinished());
+	EXPECT_EQ(halving.nextChild(), 7);
+	EXPECT_TRUE(halving.bestCandidate(stats) == stats[7].move);
+
+	halving.stop();
+	EXPECT_FALSE(halving.isActive());
+}
+
+TEST(SequentialHalvingTest, IterationsThroughChosenRootMove)
+{
+	const Board board;
+	MonteCarloSettings settings;
+	MonteCarloNode root;
+	root.runIteration(board, settings);
+	const std::vector<MoveStatistics> before = root.getMoveStatistics();
+	ASSERT_EQ(before.size(), 20u);
+	for (int i = 0; i < 10; i++)
+	{
+		root.runIteration(board, settings, 3);
+	}
+	const std::vector<MoveStatistics> after = root.getMoveStatistics();
+	for (int i = 0; i < 20; i++)
+	{
+		EXPECT_EQ(after[i].visits, before[i].visits + (i == 3 ? 10u : 0u));
+	}
+	EXPECT_EQ(root.nodeVisits(), 11u);
+}
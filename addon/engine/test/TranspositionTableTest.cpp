@@ -0,0 +1,111 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../src/AlphaBetaStrategy/TranspositionTable.h"
+
+TEST(TranspositionTableTest, StoresAndProbes)
+{
+	TranspositionTable table(1u);
+	// One megabyte of 64 byte buckets with four entries each.
+	EXPECT_EQ(table.entryCount(), 65536u);
+	const uint16_t move = TranspositionTable::packMove(Move(12, 28));
+	table.store(0x123456789abcdefull, -1234, 7u, ScoreBound::LOWER, move);
+
+	TranspositionEntry entry;
+	ASSERT_TRUE(table.probe(0x123456789abcdefull, entry));
+	EXPECT_EQ(entry.score, -1234);
+	EXPECT_EQ(entry.depth, 7u);
+	EXPECT_EQ(entry.bound, ScoreBound::LOWER);
+	EXPECT_TRUE(TranspositionTable::matchesMove(entry.move, Move(12, 28)));
+	EXPECT_FALSE(TranspositionTable::matchesMove(entry.move, Move(12, 20)));
+	EXPECT_FALSE(table.probe(0x123456789abcdeeull, entry));
+
+	table.clear();
+	EXPECT_FALSE(table.probe(0x123456789abcdefull, entry));
+}
+
+TEST(TranspositionTableTest, PacksMoves)
+{
+	EXPECT_EQ(TranspositionTable::packMove(Move()), 0u);
+	// a1 to a1 is not a move, but it must not pack to the same as no move.
+	EXPECT_NE(TranspositionTable::packMove(Move(0, 0)), 0u);
+	EXPECT_NE(TranspositionTable::packMove(Move(52, 60, Piece::QUEEN | Piece::WHITE)),
+		TranspositionTable::packMove(Move(52, 60, Piece::KNIGHT | Piece::WHITE)));
+	EXPECT_FALSE(TranspositionTable::matchesMove(0u, Move()));
+}
+
+TEST(TranspositionTableTest, PrefersDeepAndRecentEntries)
+{
+	// The smallest table has a single bucket, so all the keys compete for the same four entries.
+	TranspositionTable table(0u);
+	ASSERT_EQ(table.entryCount(), 4u);
+	for (uint64_t key = 1u; key <= 4u; key++)
+	{
+		table.store(key, 0, unsigned(key * 2u), ScoreBound::EXACT, 0u);
+	}
+	// The shallowest entry makes room.
+	table.store(5u, 0, 3u, ScoreBound::EXACT, 0u);
+	TranspositionEntry entry;
+	EXPECT_FALSE(table.probe(1u, entry));
+	EXPECT_TRUE(table.probe(5u, entry));
+
+	// A shallower bound doesn't replace a deeper result of the same search.
+	table.store(4u, 50, 1u, ScoreBound::UPPER, 0u);
+	ASSERT_TRUE(table.probe(4u, entry));
+	EXPECT_EQ(entry.depth, 8u);
+	EXPECT_EQ(entry.bound, ScoreBound::EXACT);
+
+	// Entries of old searches are replaced before the deeper ones.
+	for (int i = 0; i < 2; i++)
+	{
+		table.newSearch();
+	}
+	table.store(5u, 0, 3u, ScoreBound::EXACT, 0u);
+	table.store(6u, 0, 1u, ScoreBound::EXACT, 0u);
+	EXPECT_TRUE(table.probe(5u, entry));
+	EXPECT_TRUE(table.probe(6u, entry));
+	EXPECT_TRUE(table.probe(4u, entry));
+	EXPECT_EQ(table.usagePermille(), 500u);
+}
+
+TEST(TranspositionTableTest, ConcurrentWritesAreNeverTorn)
+{
+	TranspositionTable table(0u);
+	std::atomic<bool> stop = false;
+	// Every writer stores the same score and depth for a key, so any other combination would be torn.
+	std::vector<std::thread> writers;
+	for (int t = 0; t < 3; t++)
+	{
+		writers.emplace_back([&table, &stop, t]() {
+			for (uint64_t i = 0u; !stop; i++)
+			{
+				const uint64_t key = (i * 7u + t) % 16u + 1u;
+				table.store(key, int(key) * 1000, unsigned(key), ScoreBound::EXACT, 0u);
+			}
+		});
+	}
+	// Reads until the writers have been running for a while.
+	int hits = 0;
+	int torn = 0;
+	for (int i = 0; i < 10000000 && hits < 100000; i++)
+	{
+		const uint64_t key = uint64_t(i) % 16u + 1u;
+		TranspositionEntry entry;
+		if (table.probe(key, entry))
+		{
+			hits++;
+			if (entry.score != int(key) * 1000 || entry.depth != unsigned(key))
+				torn++;
+		}
+	}
+	stop = true;
+	for (std::thread& writer : writers)
+	{
+		writer.join();
+	}
+	EXPECT_GT(hits, 0);
+	EXPECT_EQ(torn, 0);
+}
@@ -22,15 +22,15 @@ TEST(ZobristHashTest, TogglePiece)
 {
     // Toggling should change the hash and toggling back should reset
     ZobristHash hash;
-    unsigned int hashVal0 = hash.getHash();
+    uint64_t hashVal0 = hash.getHash();
     hash.togglePiece((char)12u, Piece::WHITE | Piece::PAWN);
-    unsigned int hashVal1 = hash.getHash();
+    uint64_t hashVal1 = hash.getHash();
     hash.togglePiece((char)3u, Piece::WHITE | Piece::BISHOP);
-    unsigned int hashVal2 = hash.getHash();
+    uint64_t hashVal2 = hash.getHash();
     hash.togglePiece((char)12u, Piece::WHITE | Piece::PAWN);
-    unsigned int hashVal3 = hash.getHash();
+    uint64_t hashVal3 = hash.getHash();
     hash.togglePiece((char)3u, Piece::WHITE | Piece::BISHOP);
-    unsigned int hashVal4 = hash.getHash();
+    uint64_t hashVal4 = hash.getHash();
     ASSERT_NE(hashVal0, hashVal1);
     ASSERT_NE(hashVal1, hashVal2);
     ASSERT_NE(hashVal2, hashVal3);
@@ -42,11 +42,11 @@ TEST(ZobristHash, TogglePlayerInTurn)
 {
     // Toggling should change the hash and toggling back should reset
     ZobristHash hash;
-    unsigned int hashVal0 = hash.getHash();
+    uint64_t hashVal0 = hash.getHash();
     hash.togglePlayerInTurn();
-    unsigned int hashVal1 = hash.getHash();
+    uint64_t hashVal1 = hash.getHash();
     hash.togglePlayerInTurn();
-    unsigned int hashVal2 = hash.getHash();
+    uint64_t hashVal2 = hash.getHash();
     ASSERT_NE(hashVal0, hashVal1);
     ASSERT_EQ(hashVal0, hashVal2);
 }
\ No newline at end of file
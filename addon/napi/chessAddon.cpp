@@ -1,13 +1,17 @@
 #include "napi.h"
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <thread>
+#include "../engine/src/AlphaBetaStrategy/AlphaBetaStrategy.h"
 #include "../engine/src/GreyPawnChess.h"
 #include "../engine/src/MonteCarloStrategy/MonteCarloStrategy.h"
+#include "../engine/src/MonteCarloStrategy/PlayoutPolicy.h"
 #include "../engine/src/RandomStrategy/RandomStrategy.h"
+#include "../engine/src/RootParallelMonteCarloStrategy/RootParallelMonteCarloStrategy.h"
 #include "../engine/src/GameState.h"
 
 /**
@@ -22,10 +26,51 @@ public:
 		: Napi::ObjectWrap<GreyPawnChessAddon>(info)
 	{
 		// Parse constructor parameters here.
+		// Strategy specific options can be given as an optional second parameter, e.g. { threads: 4 }.
 		std::string stratName = (std::string)(info[0].As<Napi::String>());
+		Napi::Object options = info.Length() > 1 && info[1].IsObject() ? info[1].As<Napi::Object>() : Napi::Object::New(info.Env());
 		if (stratName == "MonteCarlo")
 		{
-			game = std::make_unique<MonteCarloStrategy>();
+			MonteCarloSettings settings{ .maxMoveCount = 50u };
+			game = CreateMonteCarloStrategy(options, settings);
+		}
+		else if (stratName == "LeafParallelMonteCarlo")
+		{
+			MonteCarloSettings settings{ .maxMoveCount = 50u };
+			settings.leafPlayouts = std::max(1u, GetUintOption(options, "leafPlayouts", 4u));
+			settings.parallelLeafPlayouts = GetBoolOption(options, "parallel", true);
+			game = CreateMonteCarloStrategy(options, settings);
+		}
+		else if (stratName == "MonteCarloEval")
+		{
+			// No playouts, new leaves are scored by a capture-resolving evaluation and backed up with implicit minimax.
+			MonteCarloSettings settings{ .resolveCapturesDepth = 4u, .evaluateLeaves = true, .minimaxWeight = 0.3f };
+			game = CreateMonteCarloStrategy(options, settings);
+		}
+		else if (stratName == "RootParallelMonteCarlo")
+		{
+			game = std::make_unique<RootParallelMonteCarloStrategy>(
+				ReadMonteCarloSettings(options, MonteCarloSettings{ .maxMoveCount = 50u }),
+				GetUintOption(options, "threads", 0u),
+				GetUintOption(options, "mergeIntervalTicks", 5u)
+			);
+		}
+		else if (stratName == "AlphaBeta")
+		{
+			// All the selective techniques are on, each can be switched off to measure what it brings.
+			AlphaBetaSettings settings;
+			settings.quiescenceDepth = GetUintOption(options, "quiescenceDepth", settings.quiescenceDepth);
+			settings.nullMovePruning = GetBoolOption(options, "nullMove", true);
+			settings.lateMoveReductions = GetBoolOption(options, "lateMoveReductions", true);
+			settings.reverseFutilityPruning = GetBoolOption(options, "reverseFutility", true);
+			settings.futilityPruning = GetBoolOption(options, "futility", true);
+			settings.checkExtensions = GetBoolOption(options, "checkExtensions", true);
+			game = std::make_unique<AlphaBetaStrategy>(
+				settings,
+				GetUintOption(options, "maxDepth", 64u),
+				size_t(GetUintOption(options, "hashMegabytes", 64u)),
+				GetUintOption(options, "threads", 0u)
+			);
 		}
 		else if (stratName == "Random") 
 		{
@@ -65,6 +110,87 @@ public:
 	}
 
 private:
+	// Reads an optional non-negative integer from the strategy options.
+	static unsigned int GetUintOption(const Napi::Object& options, const char* name, unsigned int defaultValue)
+	{
+		Napi::Value value = options.Get(name);
+		if (!value.IsNumber())
+			return defaultValue;
+		return value.As<Napi::Number>().Uint32Value();
+	}
+
+	static float GetFloatOption(const Napi::Object& options, const char* name, float defaultValue)
+	{
+		Napi::Value value = options.Get(name);
+		if (!value.IsNumber())
+			return defaultValue;
+		return value.As<Napi::Number>().FloatValue();
+	}
+
+	// Reads the search options shared by all the Monte Carlo strategies on top of the given settings.
+	static MonteCarloSettings ReadMonteCarloSettings(const Napi::Object& options, MonteCarloSettings settings)
+	{
+		// Progressive widening is off unless { widening: C } is given, { wideningExponent: a } is optional.
+		settings.wideningConstant = GetFloatOption(options, "widening", settings.wideningConstant);
+		settings.wideningExponent = GetFloatOption(options, "wideningExponent", settings.wideningExponent);
+		// With { keepMovesDepth: d } the nodes deeper than d don't store their moves.
+		settings.keepMovesDepth = GetUintOption(options, "keepMovesDepth", settings.keepMovesDepth);
+		// Adaptive playout cutoffs: { decisiveMaterial: pawns } ends playouts early, { quietExtension: moves } lets them
+		// finish exchanges and { resolveCaptures: depth } evaluates their final position with a capture-only search.
+		settings.decisiveMaterial = GetFloatOption(options, "decisiveMaterial", settings.decisiveMaterial);
+		settings.quietExtension = GetUintOption(options, "quietExtension", settings.quietExtension);
+		settings.resolveCapturesDepth = GetUintOption(options, "resolveCaptures", settings.resolveCapturesDepth);
+		settings.minimaxWeight = GetFloatOption(options, "minimaxWeight", settings.minimaxWeight);
+		// { rave: k } mixes all-moves-as-first statistics into the selection, k being the visits at which they weigh half.
+		settings.raveEquivalence = GetFloatOption(options, "rave", settings.raveEquivalence);
+		// { playoutPolicy: "heavy" } weights the playout moves by captures, checks and promotions.
+		Napi::Value policyName = options.Get("playoutPolicy");
+		if (policyName.IsString())
+		{
+			settings.playoutPolicy = PlayoutPolicy::byName(policyName.As<Napi::String>().Utf8Value());
+			if (!settings.playoutPolicy)
+				throw Napi::Error::New(options.Env(), "Unknown playout policy");
+		}
+		settings.puctConstant = GetFloatOption(options, "puctConstant", settings.puctConstant);
+		// { sequentialHalving: true } picks the root move by sequential halving when thinking on our own time.
+		settings.sequentialHalving = GetBoolOption(options, "sequentialHalving", settings.sequentialHalving);
+		return settings;
+	}
+
+	// Reads the options shared by all MonteCarloStrategy variants on top of the given settings.
+	static std::unique_ptr<GreyPawnChess> CreateMonteCarloStrategy(const Napi::Object& options, MonteCarloSettings settings)
+	{
+		settings = ReadMonteCarloSettings(options, settings);
+		auto strategy = std::make_unique<MonteCarloStrategy>(
+			settings,
+			GetBoolOption(options, "transpositions", false),
+			GetUintOption(options, "maxTreeNodes", 0u),
+			size_t(GetUintOption(options, "maxTreeMegabytes", 0u)) * 1024u * 1024u
+		);
+		// PUCT selection with { puct: true } for the built-in prior weights or { priorWeights: "path" } for weights from a file.
+		Napi::Value priorWeights = options.Get("priorWeights");
+		if (priorWeights.IsString())
+		{
+			auto prior = std::make_unique<MovePrior>();
+			if (!prior->loadFromFile(priorWeights.As<Napi::String>().Utf8Value()))
+				throw Napi::Error::New(options.Env(), "Can't read the prior weights");
+			strategy->setMovePrior(std::move(prior));
+		}
+		else if (GetBoolOption(options, "puct", false))
+		{
+			strategy->setMovePrior(std::make_unique<MovePrior>());
+		}
+		return strategy;
+	}
+
+	static bool GetBoolOption(const Napi::Object& options, const char* name, bool defaultValue)
+	{
+		Napi::Value value = options.Get(name);
+		if (!value.IsBoolean())
+			return defaultValue;
+		return value.As<Napi::Boolean>().Value();
+	}
+
 	void SetupGame(const Napi::CallbackInfo& info)
 	{
 		std::cout << "Setup game" << std::endl;
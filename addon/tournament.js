@@ -19,12 +19,26 @@ async function runTournament() {
         message: 'Select engines to play against:',
         choices: [
             { title: 'MonteCarlo', value: 'MonteCarlo' },
+            { title: 'LeafParallelMonteCarlo', value: 'LeafParallelMonteCarlo' },
+            { title: 'MonteCarloEval', value: 'MonteCarloEval' },
+            { title: 'RootParallelMonteCarlo', value: 'RootParallelMonteCarlo' },
+            { title: 'AlphaBeta', value: 'AlphaBeta' },
+            {
+                title: 'AlphaBeta without selective search',
+                value: {
+                    name: 'AlphaBeta',
+                    options: { nullMove: false, lateMoveReductions: false, reverseFutility: false, futility: false, checkExtensions: false },
+                },
+            },
             { title: 'Random', value: 'Random' },
         ],
         min: 2,
     });
 
-    const engines = selectEngines.engines.map(engine => new greyPawnChess.GreyPawnChess(engine));
+    // An engine is either a strategy name or a strategy name with its options.
+    const engines = selectEngines.engines.map(engine => typeof engine === 'string'
+        ? new greyPawnChess.GreyPawnChess(engine)
+        : new greyPawnChess.GreyPawnChess(engine.name, engine.options));
     const engineWins = selectEngines.engines.map(() => 0);
 
     for (let i = 0; i < engines.length; i++) {